@@ -30,7 +30,7 @@ DialogAsmSignature::DialogAsmSignature(QWidget *pParent, QIODevice *pDevice, XDi
     this->g_pModel = pModel;
     this->g_nAddress = nAddress;
 
-    //    XOptions::setMonoFont(ui->tableWidgetSignature);
+    //    XOptions::setMonoFont(ui->tableViewSignature);
     XOptions::setMonoFont(ui->textEditSignature);
 
     QSignalBlocker signalBlocker1(ui->spinBoxCount);
@@ -39,97 +39,86 @@ DialogAsmSignature::DialogAsmSignature(QWidget *pParent, QIODevice *pDevice, XDi
     ui->comboBoxMethod->addItem("", XDisasm::SM_NORMAL);
     ui->comboBoxMethod->addItem(tr("Relative virtual address"), XDisasm::SM_RELATIVEADDRESS);
 
-    reload();
-}
+    g_disasm_handle = 0;
+    g_pInsn = 0;
+    g_flowTable = {};
+    g_bIsEnd = false;
 
-DialogAsmSignature::~DialogAsmSignature() {
-    delete ui;
-}
-
-void DialogAsmSignature::reload() {
-    XDisasm::SIGNATURE_OPTIONS options = {};
+    XDisasm::STATS *pStats = g_pModel->getStats();
 
-    options.csarch = g_pModel->getStats()->csarch;
-    options.csmode = g_pModel->getStats()->csmode;
-    options.memoryMap = g_pModel->getStats()->memoryMap;
-    options.pDevice = g_pDevice;
-    options.nCount = ui->spinBoxCount->value();
-    options.sm = (XDisasm::SM)(ui->comboBoxMethod->currentData().toInt());
-
-    g_listRecords = XDisasm::getSignature(&options, g_nAddress);
+    if (XDisasmArch::openHandle(pStats->csarch, pStats->csmode, XDisasmArch::DP_FULL, &g_disasm_handle)) {
+        g_pInsn = cs_malloc(g_disasm_handle);
+    }
 
-    int nSymbolWidth = XLineEditHEX::getSymbolWidth(ui->tableWidgetSignature);
+    XDisasmArch::initFlowTable(&g_flowTable, pStats->csarch);
 
-    int nNumberOfRecords = g_listRecords.count();
+    g_pSignatureModel = new XDisasmSignatureModel(pStats->memoryMap.mode, this);
+    connect(g_pSignatureModel, SIGNAL(maskChanged()), this, SLOT(reloadSignature()));
 
-    ui->tableWidgetSignature->clear();
+    ui->tableViewSignature->setModel(g_pSignatureModel);
 
-    ui->tableWidgetSignature->setColumnCount(5);
-    ui->tableWidgetSignature->setRowCount(nNumberOfRecords);
+    int nSymbolWidth = XLineEditHEX::getSymbolWidth(ui->tableViewSignature);
 
-    QStringList listHeaders;
-    listHeaders.append(tr("Address"));
-    listHeaders.append(tr("Bytes"));
-    listHeaders.append(tr("Opcode"));
-    listHeaders.append(tr(""));
-    listHeaders.append(tr(""));
+    ui->tableViewSignature->setColumnWidth(XDisasmSignatureModel::SMCOLUMN_ADDRESS, nSymbolWidth * 12);
+    ui->tableViewSignature->setColumnWidth(XDisasmSignatureModel::SMCOLUMN_BYTES, nSymbolWidth * 8);
+    ui->tableViewSignature->setColumnWidth(XDisasmSignatureModel::SMCOLUMN_OPCODE, nSymbolWidth * 20);
+    ui->tableViewSignature->setColumnWidth(XDisasmSignatureModel::SMCOLUMN_DISP, nSymbolWidth * 6);
+    ui->tableViewSignature->setColumnWidth(XDisasmSignatureModel::SMCOLUMN_IMM, nSymbolWidth * 6);
 
-    ui->tableWidgetSignature->setHorizontalHeaderLabels(listHeaders);
+    ui->tableViewSignature->horizontalHeader()->setSectionResizeMode(XDisasmSignatureModel::SMCOLUMN_ADDRESS, QHeaderView::Interactive);
+    ui->tableViewSignature->horizontalHeader()->setSectionResizeMode(XDisasmSignatureModel::SMCOLUMN_BYTES, QHeaderView::Stretch);
+    ui->tableViewSignature->horizontalHeader()->setSectionResizeMode(XDisasmSignatureModel::SMCOLUMN_OPCODE, QHeaderView::Interactive);
+    ui->tableViewSignature->horizontalHeader()->setSectionResizeMode(XDisasmSignatureModel::SMCOLUMN_DISP, QHeaderView::Interactive);
+    ui->tableViewSignature->horizontalHeader()->setSectionResizeMode(XDisasmSignatureModel::SMCOLUMN_IMM, QHeaderView::Interactive);
 
-    for (int i = 0; i < nNumberOfRecords; i++) {
-        ui->tableWidgetSignature->setItem(i, 0, new QTableWidgetItem(XBinary::valueToHex(g_pModel->getStats()->memoryMap.mode, g_listRecords.at(i).nAddress)));
-        ui->tableWidgetSignature->setItem(i, 1, new QTableWidgetItem(g_listRecords.at(i).baOpcode.toHex().data()));
+    reload();
+}
 
-        if (!g_listRecords.at(i).bIsConst) {
-            QPushButton *pUseSignatureButton = new QPushButton(this);
-            pUseSignatureButton->setText(g_listRecords.at(i).sOpcode);
-            pUseSignatureButton->setCheckable(true);
-            connect(pUseSignatureButton, SIGNAL(clicked()), this, SLOT(reloadSignature()));
+DialogAsmSignature::~DialogAsmSignature() {
+    if (g_pInsn) {
+        cs_free(g_pInsn, 1);
+    }
 
-            ui->tableWidgetSignature->setCellWidget(i, 2, pUseSignatureButton);
+    if (g_disasm_handle) {
+        cs_close(&g_disasm_handle);
+    }
 
-            if (g_listRecords.at(i).nDispSize) {
-                QPushButton *pDispButton = new QPushButton(this);
-                pDispButton->setText(QString("d"));
-                pDispButton->setCheckable(true);
-                pDispButton->setMaximumWidth(nSymbolWidth * 6);
-                connect(pDispButton, SIGNAL(clicked()), this, SLOT(reloadSignature()));
+    delete ui;
+}
 
-                ui->tableWidgetSignature->setCellWidget(i, 3, pDispButton);
-            }
+void DialogAsmSignature::reload() {
+    g_pSignatureModel->clear();
+    g_bIsEnd = false;
 
-            if (g_listRecords.at(i).nImmSize) {
-                QPushButton *pImmButton = new QPushButton(this);
-                pImmButton->setText(QString("i"));
-                pImmButton->setCheckable(true);
-                pImmButton->setMaximumWidth(nSymbolWidth * 6);
-                connect(pImmButton, SIGNAL(clicked()), this, SLOT(reloadSignature()));
+    updateRecords();
+}
 
-                ui->tableWidgetSignature->setCellWidget(i, 4, pImmButton);
-            }
-        } else {
-            ui->tableWidgetSignature->setItem(i, 2, new QTableWidgetItem(g_listRecords.at(i).sOpcode));
-        }
+void DialogAsmSignature::updateRecords() {
+    int nCount = ui->spinBoxCount->value();
+    int nNumberOfRecords = g_pSignatureModel->getRecords()->count();
+
+    if (nCount < nNumberOfRecords) {
+        // Only the tail goes away, the chain is still valid
+        g_pSignatureModel->truncate(nCount);
+        g_bIsEnd = false;
+    } else if ((nCount > nNumberOfRecords) && (!g_bIsEnd) && g_pInsn) {
+        XDisasm::SIGNATURE_OPTIONS options = {};
+
+        options.csarch = g_pModel->getStats()->csarch;
+        options.csmode = g_pModel->getStats()->csmode;
+        options.memoryMap = g_pModel->getStats()->memoryMap;
+        options.pDevice = g_pDevice;
+        options.nCount = nCount;
+        options.sm = (XDisasm::SM)(ui->comboBoxMethod->currentData().toInt());
+        options.pStats = g_pModel->getStats();
+
+        g_bIsEnd = !g_pSignatureModel->extend(&options, g_disasm_handle, g_pInsn, &g_flowTable, g_nAddress);
     }
 
-    ui->tableWidgetSignature->setColumnWidth(0, nSymbolWidth * 12);
-    ui->tableWidgetSignature->setColumnWidth(1, nSymbolWidth * 8);
-    ui->tableWidgetSignature->setColumnWidth(2, nSymbolWidth * 20);
-    ui->tableWidgetSignature->setColumnWidth(3, nSymbolWidth * 6);
-    ui->tableWidgetSignature->setColumnWidth(4, nSymbolWidth * 6);
-
-    ui->tableWidgetSignature->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Interactive);
-    ui->tableWidgetSignature->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
-    ui->tableWidgetSignature->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Interactive);
-    ui->tableWidgetSignature->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Interactive);
-    ui->tableWidgetSignature->horizontalHeader()->setSectionResizeMode(4, QHeaderView::Interactive);
-
     reloadSignature();
 }
 
 void DialogAsmSignature::reloadSignature() {
-    QString sText;
-
     QChar cWild = QChar('.');
     QString _sWild = ui->lineEditWildcard->text();
 
@@ -137,82 +126,60 @@ void DialogAsmSignature::reloadSignature() {
         cWild = _sWild.at(0);
     }
 
-    int nNumberOfRecords = g_listRecords.count();
-
-    for (int i = 0; i < nNumberOfRecords; i++) {
-        bool bUse = true;
-        bool bDisp = true;
-        bool bImm = true;
+    QString sText = g_pSignatureModel->getSignature(cWild, ui->checkBoxUpper->isChecked(), ui->checkBoxSpaces->isChecked());
 
-        QPushButton *pUseSignatureButton = dynamic_cast<QPushButton *>(ui->tableWidgetSignature->cellWidget(i, 2));
-        QPushButton *pDispButton = dynamic_cast<QPushButton *>(ui->tableWidgetSignature->cellWidget(i, 3));
-        QPushButton *pImmButton = dynamic_cast<QPushButton *>(ui->tableWidgetSignature->cellWidget(i, 4));
+    ui->textEditSignature->setText(sText);
 
-        if (pUseSignatureButton) {
-            bUse = !(pUseSignatureButton->isChecked());
-        }
+    updateMatches();
+}
 
-        if (pDispButton) {
-            pDispButton->setEnabled(bUse);
-            bDisp = !(pDispButton->isChecked());
-        }
+void DialogAsmSignature::updateMatches() {
+    QByteArray baValue;
+    QByteArray baMask;
+    QList<qint32> listRecordEnds;
 
-        if (pImmButton) {
-            pImmButton->setEnabled(bUse);
-            bImm = !(pImmButton->isChecked());
-        }
+    g_pSignatureModel->getPattern(&baValue, &baMask, &listRecordEnds);
 
-        int nSize = g_listRecords.at(i).baOpcode.size();
+    XDisasmSignatureIndex *pIndex = g_pModel->getSignatureIndex();
 
-        QString sRecord;
+    qint32 nCount = pIndex->getCount(baValue, baMask, N_MATCHLIMIT);
 
-        if (bUse) {
-            sRecord = g_listRecords.at(i).baOpcode.toHex().data();
+    QString sText = tr("Matches: %1").arg(getCountString(nCount));
 
-            if (!bDisp) {
-                sRecord = replaceWild(sRecord, g_listRecords.at(i).nDispOffset, g_listRecords.at(i).nDispSize, cWild);
-            }
+    if (nCount == 1) {
+        // Fewer instructions never match less often, so the shortest unique prefix can be bisected
+        int nLow = 0;
+        int nHigh = listRecordEnds.count() - 1;
 
-            if (!bImm) {
-                sRecord = replaceWild(sRecord, g_listRecords.at(i).nImmOffset, g_listRecords.at(i).nImmSize, cWild);
-            }
+        while (nLow < nHigh) {
+            int nMiddle = (nLow + nHigh) / 2;
+            qint32 nSize = listRecordEnds.at(nMiddle);
 
-            if (g_listRecords.at(i).bIsConst) {
-                sRecord = replaceWild(sRecord, g_listRecords.at(i).nImmOffset, g_listRecords.at(i).nImmSize, QChar('$'));
-            }
-        } else {
-            for (int j = 0; j < nSize; j++) {
-                sRecord += cWild;
-                sRecord += cWild;
+            if (pIndex->getCount(baValue.left(nSize), baMask.left(nSize), 2) <= 1) {
+                nHigh = nMiddle;
+            } else {
+                nLow = nMiddle + 1;
             }
         }
 
-        sText += sRecord;
+        sText += QString(", %1: %2").arg(tr("Unique prefix"), QString::number(nLow + 1));
     }
 
-    if (ui->checkBoxUpper->isChecked()) {
-        sText = sText.toUpper();
-    } else {
-        sText = sText.toLower();
+    if (!g_corpusIndex.isEmpty()) {
+        sText += QString(", %1: %2").arg(tr("Corpus"), getCountString(g_corpusIndex.getCount(baValue, baMask, N_MATCHLIMIT)));
     }
 
-    if (ui->checkBoxSpaces->isChecked()) {
-        QString _sText;
-
-        int nSize = sText.size();
-
-        for (int i = 0; i < nSize; i++) {
-            _sText += sText.at(i);
+    ui->labelMatches->setText(sText);
+}
 
-            if ((i % 2) && (i != (nSize - 1))) {
-                _sText += QChar(' ');
-            }
-        }
+QString DialogAsmSignature::getCountString(qint32 nCount) {
+    QString sResult = QString::number(nCount);
 
-        sText = _sText;
+    if (nCount >= N_MATCHLIMIT) {
+        sResult += QChar('+');
     }
 
-    ui->textEditSignature->setText(sText);
+    return sResult;
 }
 
 void DialogAsmSignature::on_pushButtonOK_clicked() {
@@ -236,21 +203,48 @@ void DialogAsmSignature::on_pushButtonCopy_clicked() {
     clipboard->setText(ui->textEditSignature->toPlainText());
 }
 
-QString DialogAsmSignature::replaceWild(QString sString, qint32 nOffset, qint32 nSize, QChar cWild) {
-    QString sResult = sString;
-    QString sWild;
+void DialogAsmSignature::on_pushButtonCorpus_clicked() {
+    QStringList listFileNames = QFileDialog::getOpenFileNames(this, tr("Open files"));
 
-    sWild = sWild.fill(cWild, nSize * 2);
+    int nNumberOfFiles = listFileNames.count();
 
-    sResult = sResult.replace(nOffset * 2, nSize * 2, sWild);
+    if (nNumberOfFiles) {
+        QStringList listSkipped;
+        bool bIsAdded = false;
 
-    return sResult;
+        for (int i = 0; i < nNumberOfFiles; i++) {
+            QFile file;
+            file.setFileName(listFileNames.at(i));
+
+            if (file.open(QIODevice::ReadOnly)) {
+                // The whole corpus is kept in memory and indexed with 32-bit positions
+                if ((file.size() <= g_corpusIndex.getFreeSize()) && g_corpusIndex.addData(file.readAll())) {
+                    bIsAdded = bIsAdded || (file.size() > 0);
+                } else {
+                    listSkipped.append(listFileNames.at(i));
+                }
+
+                file.close();
+            }
+        }
+
+        // An index with no data would show a count for a corpus that does not exist
+        if (bIsAdded) {
+            g_corpusIndex.build();
+        }
+
+        if (listSkipped.count()) {
+            QMessageBox::warning(this, tr("Corpus"), QString("%1 (1 GiB): %2").arg(tr("The corpus size is limited"), listSkipped.join(", ")));
+        }
+
+        updateMatches();
+    }
 }
 
 void DialogAsmSignature::on_spinBoxCount_valueChanged(int nValue) {
     Q_UNUSED(nValue)
 
-    reload();
+    updateRecords();
 }
 
 void DialogAsmSignature::on_comboBoxMethod_currentIndexChanged(int nIndex) {
@@ -23,8 +23,11 @@
 
 #include <QClipboard>
 #include <QDialog>
+#include <QFileDialog>
+#include <QMessageBox>
 
 #include "xdisasmmodel.h"
+#include "xdisasmsignaturemodel.h"
 #include "xlineedithex.h"
 #include "xoptions.h"
 
@@ -35,10 +38,14 @@ class DialogAsmSignature;
 class DialogAsmSignature : public QDialog {
     Q_OBJECT
 
+    static const int N_MATCHLIMIT = 1000;
+
 public:
     explicit DialogAsmSignature(QWidget *pParent, QIODevice *pDevice, XDisasmModel *pModel, qint64 nAddress);
     ~DialogAsmSignature();
     void reload();
+    void updateRecords();
+    void updateMatches();
 
 private slots:
     void on_pushButtonOK_clicked();
@@ -47,7 +54,8 @@ private slots:
     void on_checkBoxUpper_toggled(bool bChecked);
     void on_lineEditWildcard_textChanged(const QString &sText);
     void on_pushButtonCopy_clicked();
-    QString replaceWild(QString sString, qint32 nOffset, qint32 nSize, QChar cWild);
+    void on_pushButtonCorpus_clicked();
+    QString getCountString(qint32 nCount);
     void on_spinBoxCount_valueChanged(int nValue);
 
     void on_comboBoxMethod_currentIndexChanged(int nIndex);
@@ -57,7 +65,12 @@ private:
     QIODevice *g_pDevice;
     XDisasmModel *g_pModel;
     qint64 g_nAddress;
-    QList<XDisasm::SIGNATURE_RECORD> g_listRecords;
+    XDisasmSignatureModel *g_pSignatureModel;
+    XDisasmSignatureIndex g_corpusIndex;
+    csh g_disasm_handle;
+    cs_insn *g_pInsn;
+    XDisasmArch::FLOW_TABLE g_flowTable;
+    bool g_bIsEnd;
 };
 
 #endif  // DIALOGASMSIGNATURE_H
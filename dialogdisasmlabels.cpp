@@ -28,43 +28,16 @@ DialogDisasmLabels::DialogDisasmLabels(QWidget *pParent, XDisasm::STATS *pDisasm
     this->g_pDisasmStats = pDisasmStats;
     g_nAddress = 0;
 
-    int nNumberOfLabels = pDisasmStats->mapLabelStrings.count();
+    g_pModel = new XDisasmLabelsModel(pDisasmStats, this);
 
-    QStandardItemModel *pModel = new QStandardItemModel(nNumberOfLabels, 2, this);
+    ui->tableViewLabels->setModel(g_pModel);
 
-    pModel->setHeaderData(0, Qt::Horizontal, tr("Name"));
-    pModel->setHeaderData(1, Qt::Horizontal, tr("Address"));
+    ui->tableViewLabels->horizontalHeader()->setSectionResizeMode(XDisasmLabelsModel::LMCOLUMN_NAME, QHeaderView::Stretch);
+    ui->tableViewLabels->horizontalHeader()->setSectionResizeMode(XDisasmLabelsModel::LMCOLUMN_ADDRESS, QHeaderView::Interactive);
+    ui->tableViewLabels->horizontalHeader()->setSortIndicator(XDisasmLabelsModel::LMCOLUMN_ADDRESS, Qt::AscendingOrder);
+    ui->tableViewLabels->setSortingEnabled(true);
 
-    int i = 0;
-    QMapIterator<qint64, QString> iMap(pDisasmStats->mapLabelStrings);
-    while (iMap.hasNext()) {
-        iMap.next();
-
-        QString sName = iMap.value();
-        qint64 nAddress = iMap.key();
-
-        QStandardItem *pItemName = new QStandardItem;
-        pItemName->setText(sName);
-        pItemName->setData(nAddress);
-        pModel->setItem(i, 0, pItemName);
-
-        QStandardItem *pItemAddress = new QStandardItem;
-        pItemAddress->setText(QString("0x%1").arg(nAddress, 8, 16, QChar('0')));  // TODO function in Binary
-        pModel->setItem(i, 1, pItemAddress);
-
-        i++;
-    }
-
-    ui->tableViewLabels->setModel(pModel);
-
-    ui->tableViewLabels->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
-    ui->tableViewLabels->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Interactive);
-
-    ui->pushButtonGoTo->setEnabled(nNumberOfLabels);
-
-    if (nNumberOfLabels) {
-        ui->tableViewLabels->setCurrentIndex(pModel->index(0, 0));
-    }
+    updateFilter();
 }
 
 DialogDisasmLabels::~DialogDisasmLabels() {
@@ -96,9 +69,33 @@ void DialogDisasmLabels::goTo() {
         QModelIndexList listIndexes = pSelectionModel->selectedRows(0);
 
         if (listIndexes.count()) {
-            g_nAddress = listIndexes.at(0).data(Qt::UserRole + 1).toLongLong();
+            g_nAddress = g_pModel->getAddress(listIndexes.at(0).row());
 
             done(QDialog::Accepted);
         }
     }
 }
+
+void DialogDisasmLabels::on_lineEditFilter_textChanged(const QString &sText) {
+    Q_UNUSED(sText)
+
+    updateFilter();
+}
+
+void DialogDisasmLabels::on_checkBoxSubstring_toggled(bool bState) {
+    Q_UNUSED(bState)
+
+    updateFilter();
+}
+
+void DialogDisasmLabels::updateFilter() {
+    g_pModel->setFilter(ui->lineEditFilter->text(), ui->checkBoxSubstring->isChecked());
+
+    int nNumberOfRows = g_pModel->rowCount();
+
+    ui->pushButtonGoTo->setEnabled(nNumberOfRows);
+
+    if (nNumberOfRows) {
+        ui->tableViewLabels->setCurrentIndex(g_pModel->index(0, 0));
+    }
+}
@@ -22,9 +22,8 @@
 #define DIALOGDISASMLABELS_H
 
 #include <QDialog>
-#include <QStandardItemModel>
 
-#include "xdisasm.h"
+#include "xdisasmlabelsmodel.h"
 
 namespace Ui {
 class DialogDisasmLabels;
@@ -42,11 +41,15 @@ private slots:
     void on_pushButtonClose_clicked();
     void on_pushButtonGoTo_clicked();
     void on_tableViewLabels_doubleClicked(const QModelIndex &index);
+    void on_lineEditFilter_textChanged(const QString &sText);
+    void on_checkBoxSubstring_toggled(bool bState);
+    void updateFilter();
     void goTo();
 
 private:
     Ui::DialogDisasmLabels *ui;
     XDisasm::STATS *g_pDisasmStats;
+    XDisasmLabelsModel *g_pModel;
     qint64 g_nAddress;
 };
 
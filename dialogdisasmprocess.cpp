@@ -53,8 +53,8 @@ DialogDisasmProcess::~DialogDisasmProcess() {
     delete g_pDisasm;
 }
 
-void DialogDisasmProcess::setData(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm) {
-    g_pDisasm->setData(pDevice, pOptions, nStartAddress, dm);
+void DialogDisasmProcess::setData(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm, QString sFileName) {
+    g_pDisasm->setData(pDevice, pOptions, nStartAddress, dm, sFileName);
 
     g_pThread->start();
     g_pTimer->start(1000);
@@ -69,12 +69,12 @@ void DialogDisasmProcess::timerSlot() {
     ui->lineEditOpcodes->setText(QString("%1").arg(g_pDisasm->getStats()->mapRecords.count()));
     ui->lineEditCalls->setText(QString("%1").arg(g_pDisasm->getStats()->stCalls.count()));
     ui->lineEditJumps->setText(QString("%1").arg(g_pDisasm->getStats()->stJumps.count()));
-    ui->lineEditRefFrom->setText(QString("%1").arg(g_pDisasm->getStats()->mmapRefFrom.count()));
-    ui->lineEditRefTo->setText(QString("%1").arg(g_pDisasm->getStats()->mmapRefTo.count()));
+    ui->lineEditRefFrom->setText(QString("%1").arg(g_pDisasm->getStats()->xrefsFrom.listKeys.count()));
+    ui->lineEditRefTo->setText(QString("%1").arg(g_pDisasm->getStats()->xrefsTo.listKeys.count()));
 
     ui->lineEditDataLabels->setText(QString("%1").arg(g_pDisasm->getStats()->mmapDataLabels.count()));
     ui->lineEditVB->setText(QString("%1").arg(g_pDisasm->getStats()->mapVB.count()));
-    ui->lineEditStrings->setText(QString("%1").arg(g_pDisasm->getStats()->mapLabelStrings.count()));
+    ui->lineEditStrings->setText(QString("%1").arg(g_pDisasm->getStats()->mapLabels.count()));
     ui->lineEditPositions->setText(QString("%1").arg(g_pDisasm->getStats()->mapPositions.count()));
     ui->lineEditAddresses->setText(QString("%1").arg(g_pDisasm->getStats()->mapAddresses.count()));
 }
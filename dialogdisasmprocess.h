@@ -37,7 +37,7 @@ class DialogDisasmProcess : public QDialog {
 public:
     explicit DialogDisasmProcess(QWidget *pParent = nullptr);
     ~DialogDisasmProcess();
-    void setData(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm);
+    void setData(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm, QString sFileName = "");
 
 private slots:
     void on_pushButtonCancel_clicked();
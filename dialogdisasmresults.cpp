@@ -0,0 +1,99 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "dialogdisasmresults.h"
+
+#include "ui_dialogdisasmresults.h"
+
+DialogDisasmResults::DialogDisasmResults(QWidget *pParent, XDisasm::STATS *pDisasmStats, QList<RECORD> *pListRecords, QString sTitle)
+    : QDialog(pParent), ui(new Ui::DialogDisasmResults) {
+    ui->setupUi(this);
+
+    setWindowTitle(sTitle);
+
+    g_nAddress = 0;
+
+    int nNumberOfRecords = pListRecords->count();
+
+    QStandardItemModel *pModel = new QStandardItemModel(nNumberOfRecords, 2, this);
+
+    pModel->setHeaderData(0, Qt::Horizontal, tr("Address"));
+    pModel->setHeaderData(1, Qt::Horizontal, tr("Info"));
+
+    for (int i = 0; i < nNumberOfRecords; i++) {
+        qint64 nAddress = pListRecords->at(i).nAddress;
+
+        QStandardItem *pItemAddress = new QStandardItem;
+        pItemAddress->setText(XBinary::valueToHex(pDisasmStats->memoryMap.mode, nAddress));
+        pItemAddress->setData(nAddress);
+        pModel->setItem(i, 0, pItemAddress);
+
+        QStandardItem *pItemInfo = new QStandardItem;
+        pItemInfo->setText(pListRecords->at(i).sInfo);
+        pModel->setItem(i, 1, pItemInfo);
+    }
+
+    ui->tableViewResults->setModel(pModel);
+
+    ui->tableViewResults->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Interactive);
+    ui->tableViewResults->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+
+    ui->pushButtonGoTo->setEnabled(nNumberOfRecords);
+
+    if (nNumberOfRecords) {
+        ui->tableViewResults->setCurrentIndex(pModel->index(0, 0));
+    }
+}
+
+DialogDisasmResults::~DialogDisasmResults() {
+    delete ui;
+}
+
+qint64 DialogDisasmResults::getAddress() {
+    return g_nAddress;
+}
+
+void DialogDisasmResults::on_pushButtonClose_clicked() {
+    done(QDialog::Rejected);
+}
+
+void DialogDisasmResults::on_pushButtonGoTo_clicked() {
+    goTo();
+}
+
+void DialogDisasmResults::on_tableViewResults_doubleClicked(const QModelIndex &index) {
+    Q_UNUSED(index)
+
+    goTo();
+}
+
+void DialogDisasmResults::goTo() {
+    QItemSelectionModel *pSelectionModel = ui->tableViewResults->selectionModel();
+
+    if (pSelectionModel) {
+        QModelIndexList listIndexes = pSelectionModel->selectedRows(0);
+
+        if (listIndexes.count()) {
+            g_nAddress = listIndexes.at(0).data(Qt::UserRole + 1).toLongLong();
+
+            done(QDialog::Accepted);
+        }
+    }
+}
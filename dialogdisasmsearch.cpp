@@ -0,0 +1,182 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "dialogdisasmsearch.h"
+
+#include "ui_dialogdisasmsearch.h"
+
+DialogDisasmSearch::DialogDisasmSearch(QWidget *pParent, QIODevice *pDevice, XDisasm::STATS *pDisasmStats, bool bShowLabels)
+    : QDialog(pParent), ui(new Ui::DialogDisasmSearch) {
+    ui->setupUi(this);
+
+    g_pDevice = pDevice;
+    g_pDisasmStats = pDisasmStats;
+    g_bShowLabels = bShowLabels;
+    g_bStop = false;
+    g_nAddress = 0;
+
+    g_pModel = new QStandardItemModel(0, 2, this);
+
+    g_pModel->setHeaderData(0, Qt::Horizontal, tr("Address"));
+    g_pModel->setHeaderData(1, Qt::Horizontal, tr("Text"));
+
+    ui->tableViewResults->setModel(g_pModel);
+
+    ui->tableViewResults->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Interactive);
+    ui->tableViewResults->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+
+    ui->pushButtonGoTo->setEnabled(false);
+
+    connect(&g_watcher, SIGNAL(resultReadyAt(int)), this, SLOT(resultReadyAt(int)));
+    connect(&g_watcher, SIGNAL(finished()), this, SLOT(finished()));
+    connect(ui->lineEditSearch, SIGNAL(returnPressed()), this, SLOT(search()));
+}
+
+DialogDisasmSearch::~DialogDisasmSearch() {
+    stop();
+
+    delete ui;
+}
+
+qint64 DialogDisasmSearch::getAddress() {
+    return g_nAddress;
+}
+
+void DialogDisasmSearch::on_pushButtonSearch_clicked() {
+    search();
+}
+
+void DialogDisasmSearch::on_pushButtonClose_clicked() {
+    stop();
+
+    done(QDialog::Rejected);
+}
+
+void DialogDisasmSearch::on_pushButtonGoTo_clicked() {
+    goTo();
+}
+
+void DialogDisasmSearch::on_tableViewResults_doubleClicked(const QModelIndex &index) {
+    Q_UNUSED(index)
+
+    goTo();
+}
+
+void DialogDisasmSearch::search() {
+    stop();
+
+    g_pModel->removeRows(0, g_pModel->rowCount());
+    ui->pushButtonGoTo->setEnabled(false);
+
+    QString sText = ui->lineEditSearch->text();
+
+    if (sText != "") {
+        if (!ui->checkBoxRegex->isChecked()) {
+            sText = QRegularExpression::escape(sText);
+        }
+
+        QRegularExpression regExp(sText, QRegularExpression::CaseInsensitiveOption);
+
+        if (regExp.isValid()) {
+            g_bStop = false;
+
+            QList<XDisasm::SEARCH_CHUNK> listChunks = XDisasm::getSearchChunks(g_pDevice, g_pDisasmStats, regExp, g_bShowLabels, &g_bStop);
+
+            ui->labelStatus->setText(tr("Searching..."));
+            ui->pushButtonSearch->setEnabled(false);
+
+            g_watcher.setFuture(QtConcurrent::mapped(listChunks, XDisasm::searchChunk));
+        } else {
+            ui->labelStatus->setText(regExp.errorString());
+        }
+    }
+}
+
+void DialogDisasmSearch::stop() {
+    if (g_watcher.isRunning()) {
+        g_bStop = true;
+
+        g_watcher.waitForFinished();
+    }
+}
+
+void DialogDisasmSearch::resultReadyAt(int nIndex) {
+    QList<XDisasm::SEARCH_RESULT> listResults = g_watcher.resultAt(nIndex);
+
+    int nNumberOfResults = listResults.count();
+
+    for (int i = 0; i < nNumberOfResults; i++) {
+        qint64 nAddress = listResults.at(i).nAddress;
+
+        QStandardItem *pItemAddress = new QStandardItem;
+        pItemAddress->setText(XBinary::valueToHex(g_pDisasmStats->memoryMap.mode, nAddress));
+        pItemAddress->setData(nAddress);
+
+        QStandardItem *pItemText = new QStandardItem;
+        pItemText->setText(listResults.at(i).sText);
+
+        g_pModel->appendRow(QList<QStandardItem *>() << pItemAddress << pItemText);
+    }
+
+    ui->labelStatus->setText(QString("%1: %2").arg(tr("Results")).arg(g_pModel->rowCount()));
+}
+
+void DialogDisasmSearch::finished() {
+    // Chunks complete out of order
+    g_pModel->setSortRole(Qt::UserRole + 1);
+    g_pModel->sort(0);
+
+    int nNumberOfResults = g_pModel->rowCount();
+
+    if (g_bStop) {
+        ui->labelStatus->setText(QString("%1: %2 (%3)").arg(tr("Results")).arg(nNumberOfResults).arg(tr("Stopped")));
+    } else {
+        ui->labelStatus->setText(QString("%1: %2").arg(tr("Results")).arg(nNumberOfResults));
+    }
+
+    ui->pushButtonSearch->setEnabled(true);
+    ui->pushButtonGoTo->setEnabled(nNumberOfResults);
+
+    if (nNumberOfResults) {
+        ui->tableViewResults->setCurrentIndex(g_pModel->index(0, 0));
+    }
+}
+
+void DialogDisasmSearch::goTo() {
+    QItemSelectionModel *pSelectionModel = ui->tableViewResults->selectionModel();
+
+    if (pSelectionModel) {
+        QModelIndexList listIndexes = pSelectionModel->selectedRows(0);
+
+        if (listIndexes.count()) {
+            g_nAddress = listIndexes.at(0).data(Qt::UserRole + 1).toLongLong();
+
+            stop();
+
+            done(QDialog::Accepted);
+        }
+    }
+}
+
+void DialogDisasmSearch::reject() {
+    stop();
+
+    QDialog::reject();
+}
@@ -20,33 +20,40 @@
 //
 #include "xdisasm.h"
 
+#include "xdisasmcolumns.h"
+
 XDisasm::XDisasm(QObject *pParent) : QObject(pParent) {
     g_pOptions = 0;
     g_nStartAddress = 0;
     g_disasm_handle = 0;
+    g_pInsn = 0;
+    g_nReadBufferOffset = 0;
+    g_nReadBufferSize = 0;
     g_bStop = false;
+    g_pConsumer = 0;
 }
 
 XDisasm::~XDisasm() {
-    if (g_disasm_handle) {
-        cs_close(&g_disasm_handle);
-        g_disasm_handle = 0;
-    }
+    _closeHandle();
 }
 
-void XDisasm::setData(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm) {
+void XDisasm::setData(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm, QString sFileName) {
     this->g_pDevice = pDevice;
     this->g_pOptions = pOptions;
     this->g_nStartAddress = nStartAddress;
     this->g_dm = dm;
+    this->g_sFileName = sFileName;
 }
 
-void XDisasm::_disasm(qint64 nInitAddress, qint64 nAddress) {
-    g_pOptions->stats.mmapRefFrom.insert(nAddress, nInitAddress);
-    g_pOptions->stats.mmapRefTo.insert(nInitAddress, nAddress);
+void XDisasm::_disasm(qint64 nAddress) {
+    cs_arch csarch = g_pOptions->stats.csarch;
+    cs_mode csmode = g_pOptions->stats.csmode;
+    qint32 nDelaySlots = -1;
 
     while (!g_bStop) {
-        if (g_pOptions->stats.mapRecords.contains(nAddress)) {
+        QMap<qint64, RECORD>::const_iterator iterRecord = g_pOptions->stats.mapRecords.constFind(nAddress);
+
+        if ((iterRecord != g_pOptions->stats.mapRecords.constEnd()) && (iterRecord.value().type != RECORD_TYPE_DATA)) {
             break;
         }
 
@@ -56,63 +63,88 @@ void XDisasm::_disasm(qint64 nInitAddress, qint64 nAddress) {
         qint64 nOffset = XBinary::addressToOffset(&(g_pOptions->stats.memoryMap),
                                                   nAddress);  // TODO optimize if image
         if (nOffset != -1) {
-            char opcode[N_X64_OPCODE_SIZE];
-
-            XBinary::_zeroMemory(opcode, N_X64_OPCODE_SIZE);
+            qint64 nDataSize = 0;
+            const char *pData = _readData(nOffset, &nDataSize);
 
-            size_t nDataSize = XBinary::read_array(g_pDevice, nOffset, opcode, N_X64_OPCODE_SIZE);
+            bool bIsZeroFilled = XBinary::_isMemoryZeroFilled((char *)pData, nDataSize);
 
-            uint8_t *pData = (uint8_t *)opcode;
+            const uint8_t *_pData = (const uint8_t *)pData;
+            size_t _nDataSize = nDataSize;
+            uint64_t _nAddress = nAddress;
 
-            cs_insn *pInsn = 0;
-            size_t nNumberOfOpcodes = cs_disasm(g_disasm_handle, pData, nDataSize, nAddress, 1, &pInsn);
+            if (cs_disasm_iter(g_disasm_handle, &_pData, &_nDataSize, &_nAddress, g_pInsn)) {
+                // g_pInsn and the read buffer are reused by nested calls, so keep what is needed after the branch
+                qint32 nInsnSize = g_pInsn->size;
 
-            if (nNumberOfOpcodes > 0) {
-                if (pInsn->size > 1) {
-                    bStopBranch = !XBinary::isAddressPhysical(&(g_pOptions->stats.memoryMap), nAddress + pInsn->size - 1);
+                if (nInsnSize > 1) {
+                    bStopBranch = !XBinary::isAddressPhysical(&(g_pOptions->stats.memoryMap), nAddress + nInsnSize - 1);
                 }
 
                 if (!bStopBranch) {
-                    for (int i = 0; i < pInsn->detail->x86.op_count; i++) {
-                        if (pInsn->detail->x86.operands[i].type == X86_OP_IMM) {
-                            qint64 nImm = pInsn->detail->x86.operands[i].imm;
+                    quint32 nFlow = XDisasmArch::getFlow(&g_flowTable, g_disasm_handle, g_pInsn);
+                    qint64 nImm = 0;
 
-                            if (isJmpOpcode(pInsn->id)) {
-                                if (isCallOpcode(pInsn->id)) {
-                                    g_pOptions->stats.stCalls.insert(nImm);
-                                } else {
-                                    g_pOptions->stats.stJumps.insert(nImm);
-                                }
+                    quint32 nOpcodeID = g_pInsn->id;
+                    quint64 nValues[N_QUERY_MAXVALUES];
+                    qint32 nNumberOfValues = XDisasmArch::getOperandValues(csarch, csmode, g_pInsn, nValues, N_QUERY_MAXVALUES);
 
-                                if (nAddress != nImm) {
-                                    _disasm(nAddress, nImm);
-                                }
-                            }
+                    if ((nFlow & (XDisasmArch::FLOW_JUMP | XDisasmArch::FLOW_CALL)) && XDisasmArch::getBranchAddress(csarch, csmode, g_pInsn, &nImm)) {
+                        bool bSkip = false;
+
+                        if (nFlow & XDisasmArch::FLOW_CALL) {
+                            g_pOptions->stats.stCalls.insert(nImm);
+                            _addXref(nAddress, nImm, XREF_TYPE_CALL);
+
+                            // Known library code gets a name but is not traversed
+                            bSkip = _isLibraryFunction(nImm);
+                        } else {
+                            g_pOptions->stats.stJumps.insert(nImm);
+                            _addXref(nAddress, nImm, XREF_TYPE_JUMP);
+                        }
+
+                        if ((nAddress != nImm) && (!bSkip)) {
+                            _disasm(nImm);
                         }
+                    } else if (XDisasmArch::getDataAddress(csarch, csmode, g_pInsn, &nImm)) {
+                        _addXref(nAddress, nImm, XREF_TYPE_DATA);
                     }
 
                     RECORD opcode = {};
                     opcode.nOffset = nOffset;
-                    opcode.nSize = pInsn->size;
+                    opcode.nSize = nInsnSize;
                     opcode.type = RECORD_TYPE_OPCODE;
 
-                    if (!_insertOpcode(nAddress, &opcode)) {
+                    // A guessed string gives way to code
+                    _removeDataRecords(nAddress, nInsnSize);
+
+                    if (_insertOpcode(nAddress, &opcode)) {
+                        _addQueryEntries(nAddress, nOpcodeID, nValues, nNumberOfValues);
+                    } else {
                         bStopBranch = true;
                     }
 
-                    nDelta = pInsn->size;
+                    nDelta = nInsnSize;
 
-                    if (isEndBranchOpcode(pInsn->id)) {
-                        bStopBranch = true;
+                    if (nDelaySlots != -1) {
+                        // MIPS executes the instruction after a branch
+                        nDelaySlots--;
+
+                        if (nDelaySlots <= 0) {
+                            bStopBranch = true;
+                        }
+                    } else if (nFlow & XDisasmArch::FLOW_END) {
+                        nDelaySlots = XDisasmArch::getDelaySlots(csarch);
+
+                        if (nDelaySlots == 0) {
+                            bStopBranch = true;
+                        }
                     }
                 }
-
-                cs_free(pInsn, nNumberOfOpcodes);
             } else {
                 bStopBranch = true;
             }
 
-            if (XBinary::_isMemoryZeroFilled(opcode, N_X64_OPCODE_SIZE)) {
+            if (bIsZeroFilled) {
                 bStopBranch = true;
             }
         }
@@ -129,421 +161,2401 @@ void XDisasm::_disasm(qint64 nInitAddress, qint64 nAddress) {
     }
 }
 
-void XDisasm::processDisasm() {
-    g_bStop = false;
+void XDisasm::_stream(qint64 nAddress) {
+    cs_arch csarch = g_pOptions->stats.csarch;
+    cs_mode csmode = g_pOptions->stats.csmode;
 
-    if (!g_pOptions->stats.bInit) {
-        g_pOptions->stats.csarch = CS_ARCH_X86;
-        g_pOptions->stats.csmode = CS_MODE_16;
-
-        XBinary::FT fileType = g_pOptions->fileType;
-
-        if (fileType == XBinary::FT_UNKNOWN) {
-            fileType = XBinary::getPrefFileType(g_pDevice);
-        }
-
-        if ((fileType == XBinary::FT_PE32) || (fileType == XBinary::FT_PE64)) {
-            XPE pe(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
-
-            g_pOptions->stats.memoryMap = pe.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = pe.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-            g_pOptions->stats.bIsOverlayPresent = pe.isOverlayPresent();
-            g_pOptions->stats.nOverlaySize = pe.getOverlaySize();
-            g_pOptions->stats.nOverlayOffset = pe.getOverlayOffset();
-
-            XBinary::MODE modeBinary = pe.getMode();
-
-            g_pOptions->stats.csarch = CS_ARCH_X86;
-            if (modeBinary == XBinary::MODE_32) {
-                g_pOptions->stats.csmode = CS_MODE_32;
-            } else if (modeBinary == XBinary::MODE_64) {
-                g_pOptions->stats.csmode = CS_MODE_64;
-            }
-        } else if ((fileType == XBinary::FT_ELF32) || (fileType == XBinary::FT_ELF64)) {
-            XELF elf(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+    // Same walk as _disasm, but with a work list so deep call chains do not use the stack
+    QVector<qint64> listAddresses;
+    listAddresses.append(nAddress);
+
+    while ((!listAddresses.isEmpty()) && (!g_bStop)) {
+        qint64 nCurrentAddress = listAddresses.takeLast();
+        qint32 nDelaySlots = -1;
 
-            g_pOptions->stats.memoryMap = elf.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = elf.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-            g_pOptions->stats.bIsOverlayPresent = elf.isOverlayPresent();
-            g_pOptions->stats.nOverlaySize = elf.getOverlaySize();
-            g_pOptions->stats.nOverlayOffset = elf.getOverlayOffset();
-        } else if ((fileType == XBinary::FT_MACHO32) || (fileType == XBinary::FT_MACHO64)) {
-            XMACH mach(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+        while (!g_bStop) {
+            qint64 nOffset = XBinary::addressToOffset(&(g_pOptions->stats.memoryMap), nCurrentAddress);
 
-            g_pOptions->stats.memoryMap = mach.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = mach.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-            g_pOptions->stats.bIsOverlayPresent = mach.isOverlayPresent();
-            g_pOptions->stats.nOverlaySize = mach.getOverlaySize();
-            g_pOptions->stats.nOverlayOffset = mach.getOverlayOffset();
-        } else if (fileType == XBinary::FT_MSDOS) {
-            XMSDOS msdos(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+            if ((nOffset == -1) || (!_testAndSet(&g_baVisited, nCurrentAddress))) {
+                break;
+            }
 
-            g_pOptions->stats.memoryMap = msdos.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = msdos.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-            g_pOptions->stats.bIsOverlayPresent = msdos.isOverlayPresent();
-            g_pOptions->stats.nOverlaySize = msdos.getOverlaySize();
-            g_pOptions->stats.nOverlayOffset = msdos.getOverlayOffset();
-        } else if (fileType == XBinary::FT_NE) {
-            XNE ne(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+            qint64 nDataSize = 0;
+            const char *pData = _readData(nOffset, &nDataSize);
 
-            g_pOptions->stats.memoryMap = ne.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = ne.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-            g_pOptions->stats.bIsOverlayPresent = ne.isOverlayPresent();
-            g_pOptions->stats.nOverlaySize = ne.getOverlaySize();
-            g_pOptions->stats.nOverlayOffset = ne.getOverlayOffset();
-        } else if ((fileType == XBinary::FT_LE) || (fileType == XBinary::FT_LX)) {
-            XLE le(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+            bool bStopBranch = XBinary::_isMemoryZeroFilled((char *)pData, nDataSize);
 
-            g_pOptions->stats.memoryMap = le.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = le.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-            g_pOptions->stats.bIsOverlayPresent = le.isOverlayPresent();
-            g_pOptions->stats.nOverlaySize = le.getOverlaySize();
-            g_pOptions->stats.nOverlayOffset = le.getOverlayOffset();
-        } else if (fileType == XBinary::FT_COM) {
-            XCOM xcom(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+            const uint8_t *_pData = (const uint8_t *)pData;
+            size_t _nDataSize = nDataSize;
+            uint64_t _nAddress = nCurrentAddress;
 
-            g_pOptions->stats.memoryMap = xcom.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = xcom.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-        } else if ((fileType == XBinary::FT_BINARY16) || (fileType == XBinary::FT_BINARY)) {
-            XBinary binary(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+            if (!cs_disasm_iter(g_disasm_handle, &_pData, &_nDataSize, &_nAddress, g_pInsn)) {
+                break;
+            }
 
-            binary.setArch("8086");
-            binary.setMode(XBinary::MODE_16);
+            qint32 nInsnSize = g_pInsn->size;
 
-            g_pOptions->stats.memoryMap = binary.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = binary.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-        } else if (fileType == XBinary::FT_BINARY32) {
-            XBinary binary(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+            if ((nInsnSize > 1) && (!XBinary::isAddressPhysical(&(g_pOptions->stats.memoryMap), nCurrentAddress + nInsnSize - 1))) {
+                break;
+            }
 
-            binary.setArch("386");
-            binary.setMode(XBinary::MODE_32);
+            g_pConsumer->instruction(nCurrentAddress, nInsnSize, g_pInsn->id, pData);
 
-            g_pOptions->stats.memoryMap = binary.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = binary.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-        } else if (fileType == XBinary::FT_BINARY64) {
-            XBinary binary(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+            quint32 nFlow = XDisasmArch::getFlow(&g_flowTable, g_disasm_handle, g_pInsn);
+            qint64 nImm = 0;
 
-            binary.setArch("AMD64");
-            binary.setMode(XBinary::MODE_64);
+            if ((nFlow & (XDisasmArch::FLOW_JUMP | XDisasmArch::FLOW_CALL)) && XDisasmArch::getBranchAddress(csarch, csmode, g_pInsn, &nImm)) {
+                bool bIsCall = (nFlow & XDisasmArch::FLOW_CALL);
 
-            g_pOptions->stats.memoryMap = binary.getMemoryMap();
-            g_pOptions->stats.nEntryPointAddress = binary.getEntryPointAddress(&g_pOptions->stats.memoryMap);
-        }
+                g_pConsumer->edge(nCurrentAddress, nImm, bIsCall ? XREF_TYPE_CALL : XREF_TYPE_JUMP);
 
-        g_pOptions->stats.nImageBase = g_pOptions->stats.memoryMap.nModuleAddress;
-        //        pOptions->stats.nImageSize=XBinary::getTotalVirtualSize(&(pOptions->stats.memoryMap));
-        g_pOptions->stats.nImageSize = g_pOptions->stats.memoryMap.nImageSize;
+                if (_testAndSet(&g_baLabels, nImm)) {
+                    g_pConsumer->label(nImm, bIsCall ? LABEL_TYPE_FUNCTION : LABEL_TYPE_JUMP);
+                }
 
-        if (XBinary::isX86asm(g_pOptions->stats.memoryMap.sArch)) {
-            g_pOptions->stats.csarch = CS_ARCH_X86;
-            if ((g_pOptions->stats.memoryMap.mode == XBinary::MODE_16) || (g_pOptions->stats.memoryMap.mode == XBinary::MODE_16SEG)) {
-                g_pOptions->stats.csmode = CS_MODE_16;
-            } else if (g_pOptions->stats.memoryMap.mode == XBinary::MODE_32) {
-                g_pOptions->stats.csmode = CS_MODE_32;
-            } else if (g_pOptions->stats.memoryMap.mode == XBinary::MODE_64) {
-                g_pOptions->stats.csmode = CS_MODE_64;
-            }
-
-            cs_err err = cs_open(g_pOptions->stats.csarch, g_pOptions->stats.csmode, &g_disasm_handle);
-            if (!err) {
-                cs_option(g_disasm_handle, CS_OPT_DETAIL,
-                          CS_OPT_ON);  // TODO Check
+                if (nImm != nCurrentAddress) {
+                    listAddresses.append(nImm);
+                }
+            } else if (XDisasmArch::getDataAddress(csarch, csmode, g_pInsn, &nImm) && XBinary::isAddressValid(&(g_pOptions->stats.memoryMap), nImm)) {
+                g_pConsumer->edge(nCurrentAddress, nImm, XREF_TYPE_DATA);
             }
 
-            _disasm(0, g_pOptions->stats.nEntryPointAddress);
-
-            if (g_nStartAddress != -1) {
-                if (g_nStartAddress != g_pOptions->stats.nEntryPointAddress) {
-                    _disasm(0, g_nStartAddress);
-                }
-            }
+            if (nDelaySlots != -1) {
+                nDelaySlots--;
 
-            _adjust();
-            _updatePositions();
+                if (nDelaySlots <= 0) {
+                    bStopBranch = true;
+                }
+            } else if (nFlow & XDisasmArch::FLOW_END) {
+                nDelaySlots = XDisasmArch::getDelaySlots(csarch);
 
-            g_pOptions->stats.bInit = true;
-
-            if (g_disasm_handle) {
-                cs_close(&g_disasm_handle);
-                g_disasm_handle = 0;
-            }
-        } else {
-            emit errorMessage(QString("%1: %2").arg("Architecture").arg(g_pOptions->stats.memoryMap.sArch));
-        }
-    } else {
-        if (XBinary::isX86asm(g_pOptions->stats.memoryMap.sArch)) {
-            // TODO move to function
-            if (g_disasm_handle == 0) {
-                cs_err err = cs_open(g_pOptions->stats.csarch, g_pOptions->stats.csmode, &g_disasm_handle);
-                if (!err) {
-                    cs_option(g_disasm_handle, CS_OPT_DETAIL,
-                              CS_OPT_ON);  // TODO Check
+                if (nDelaySlots == 0) {
+                    bStopBranch = true;
                 }
             }
 
-            _disasm(0, g_nStartAddress);
-
-            _adjust();
-            _updatePositions();
-
-            if (g_disasm_handle) {
-                cs_close(&g_disasm_handle);
-                g_disasm_handle = 0;
+            if (bStopBranch) {
+                break;
             }
-        } else {
-            emit errorMessage(QString("%1: %2").arg("Architecture").arg(g_pOptions->stats.memoryMap.sArch));
+
+            nCurrentAddress += nInsnSize;
         }
     }
-
-    emit processFinished();
 }
 
-void XDisasm::processToData() {
-    g_pOptions->stats.mapRecords.remove(this->g_nStartAddress);
+bool XDisasm::_testAndSet(QBitArray *pBitArray, qint64 nAddress) {
+    bool bResult = false;
 
-    _adjust();
-    _updatePositions();
+    qint64 nIndex = nAddress - g_pOptions->stats.nImageBase;
 
-    emit processFinished();
-}
+    if ((nIndex >= 0) && (nIndex < pBitArray->size()) && (!pBitArray->testBit(nIndex))) {
+        pBitArray->setBit(nIndex);
 
-void XDisasm::process() {
-    if (g_dm == DM_DISASM) {
-        processDisasm();
-    } else if (g_dm == DM_TODATA) {
-        processToData();
+        bResult = true;
     }
-}
 
-void XDisasm::stop() {
-    g_bStop = true;
+    return bResult;
 }
 
-XDisasm::STATS *XDisasm::getStats() {
-    return &(g_pOptions->stats);
-}
+bool XDisasm::_initStats() {
+    bool bResult = false;
 
-void XDisasm::_adjust() {
-    g_pOptions->stats.mapLabelStrings.clear();
-    g_pOptions->stats.mapVB.clear();
+    if (!g_pOptions->stats.bInit) {
+        _loadStats();
+    }
 
-    if (!g_bStop) {
-        g_pOptions->stats.mapLabelStrings.insert(g_pOptions->stats.nEntryPointAddress, "entry_point");
+    cs_arch csarch = CS_ARCH_X86;
+    cs_mode csmode = CS_MODE_16;
 
-        QSetIterator<qint64> iFL(g_pOptions->stats.stCalls);
-        while (iFL.hasNext() && (!g_bStop)) {
-            qint64 nAddress = iFL.next();
+    if (XDisasmArch::getCsArchMode(&(g_pOptions->stats.memoryMap), &csarch, &csmode)) {
+        bResult = true;
+    } else {
+        emit errorMessage(QString("%1: %2").arg("Architecture").arg(g_pOptions->stats.memoryMap.sArch));
+    }
 
-            if (!g_pOptions->stats.mapLabelStrings.contains(nAddress)) {
-                g_pOptions->stats.mapLabelStrings.insert(nAddress, QString("func_%1").arg(nAddress, 0, 16));
-            }
-        }
+    return bResult;
+}
 
-        QSetIterator<qint64> iJL(g_pOptions->stats.stJumps);
-        while (iJL.hasNext() && (!g_bStop)) {
-            qint64 nAddress = iJL.next();
+void XDisasm::_analyze(bool bIsInit) {
+    _loadFingerprints();
+    _openHandle();
 
-            if (!g_pOptions->stats.mapLabelStrings.contains(nAddress)) {
-                g_pOptions->stats.mapLabelStrings.insert(nAddress, QString("lab_%1").arg(nAddress, 0, 16));
+    if (!bIsInit) {
+        _disasm(g_pOptions->stats.nEntryPointAddress);
+
+        if (g_nStartAddress != -1) {
+            if (g_nStartAddress != g_pOptions->stats.nEntryPointAddress) {
+                _disasm(g_nStartAddress);
             }
         }
 
-        //    QSet<qint64> stFunctionLabels;
-        //    QSet<qint64> stJmpLabels;
-        //    QMap<qint64,qint64> mapDataSizeLabels; // Set Max
-        //    QSet<qint64> stDataLabels;
+        _discoverPointers();
+    } else {
+        _disasm(g_nStartAddress);
+    }
 
-        // TODO Strings
-        QMapIterator<qint64, XDisasm::RECORD> iRecords(g_pOptions->stats.mapRecords);
-        while (iRecords.hasNext() && (!g_bStop)) {
-            iRecords.next();
+    _recognizeFunctions();
+    _adjust();
+    _updatePositions();
 
-            qint64 nAddress = iRecords.key();
+    g_pOptions->stats.bInit = true;
 
-            VIEW_BLOCK record;
-            record.nAddress = nAddress;
-            record.nOffset = iRecords.value().nOffset;
-            record.nSize = iRecords.value().nSize;
+    _closeHandle();
+}
 
-            if (iRecords.value().type == RECORD_TYPE_OPCODE) {
-                record.type = VBT_OPCODE;
-            } else if (iRecords.value().type == RECORD_TYPE_DATA) {
-                record.type = VBT_DATA;
-            }
+void XDisasm::_loadStats() {
+    g_pOptions->stats.csarch = CS_ARCH_X86;
+    g_pOptions->stats.csmode = CS_MODE_16;
 
-            if (!g_pOptions->stats.mapVB.contains(nAddress)) {
-                g_pOptions->stats.mapVB.insert(nAddress, record);
-            }
-        }
+    XBinary::FT fileType = g_pOptions->fileType;
 
-        int nNumberOfRecords = g_pOptions->stats.memoryMap.listRecords.count();  // TODO
+    if (fileType == XBinary::FT_UNKNOWN) {
+        fileType = XBinary::getPrefFileType(g_pDevice);
+    }
 
-        for (int i = 0; (i < nNumberOfRecords) && (!g_bStop); i++) {
-            qint64 nRegionAddress = g_pOptions->stats.memoryMap.listRecords.at(i).nAddress;
-            qint64 nRegionOffset = g_pOptions->stats.memoryMap.listRecords.at(i).nOffset;
-            qint64 nRegionSize = g_pOptions->stats.memoryMap.listRecords.at(i).nSize;
+    if ((fileType == XBinary::FT_PE32) || (fileType == XBinary::FT_PE64)) {
+        XPE pe(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
 
-            if (nRegionAddress != -1) {
-                for (qint64 nCurrentAddress = nRegionAddress, nCurrentOffset = nRegionOffset;
-                     (nCurrentAddress < (nRegionAddress + nRegionSize)) && (!g_bStop);) {
-                    VIEW_BLOCK vb = g_pOptions->stats.mapVB.value(nCurrentAddress);
+        g_pOptions->stats.memoryMap = pe.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = pe.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+        g_pOptions->stats.bIsOverlayPresent = pe.isOverlayPresent();
+        g_pOptions->stats.nOverlaySize = pe.getOverlaySize();
+        g_pOptions->stats.nOverlayOffset = pe.getOverlayOffset();
 
-                    if (!vb.nSize) {
-                        QMap<qint64, VIEW_BLOCK>::const_iterator iter = g_pOptions->stats.mapVB.lowerBound(nCurrentAddress);
+        QList<qint64> listRelocs = pe.getRelocsAsRVAList();
 
-                        qint64 nBlockAddress = 0;
-                        qint64 nBlockOffset = 0;
-                        qint64 nBlockSize = 0;
+        int nNumberOfRelocs = listRelocs.count();
 
-                        qint64 nIterKey = iter.key();
+        for (int i = 0; i < nNumberOfRelocs; i++) {
+            g_pOptions->stats.listRelocs.append(XBinary::relAddressToAddress(&(g_pOptions->stats.memoryMap), listRelocs.at(i)));
+        }
+    } else if ((fileType == XBinary::FT_ELF32) || (fileType == XBinary::FT_ELF64)) {
+        XELF elf(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+
+        g_pOptions->stats.memoryMap = elf.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = elf.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+        g_pOptions->stats.bIsOverlayPresent = elf.isOverlayPresent();
+        g_pOptions->stats.nOverlaySize = elf.getOverlaySize();
+        g_pOptions->stats.nOverlayOffset = elf.getOverlayOffset();
+    } else if ((fileType == XBinary::FT_MACHO32) || (fileType == XBinary::FT_MACHO64)) {
+        XMACH mach(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+
+        g_pOptions->stats.memoryMap = mach.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = mach.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+        g_pOptions->stats.bIsOverlayPresent = mach.isOverlayPresent();
+        g_pOptions->stats.nOverlaySize = mach.getOverlaySize();
+        g_pOptions->stats.nOverlayOffset = mach.getOverlayOffset();
+    } else if (fileType == XBinary::FT_MSDOS) {
+        XMSDOS msdos(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+
+        g_pOptions->stats.memoryMap = msdos.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = msdos.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+        g_pOptions->stats.bIsOverlayPresent = msdos.isOverlayPresent();
+        g_pOptions->stats.nOverlaySize = msdos.getOverlaySize();
+        g_pOptions->stats.nOverlayOffset = msdos.getOverlayOffset();
+    } else if (fileType == XBinary::FT_NE) {
+        XNE ne(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+
+        g_pOptions->stats.memoryMap = ne.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = ne.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+        g_pOptions->stats.bIsOverlayPresent = ne.isOverlayPresent();
+        g_pOptions->stats.nOverlaySize = ne.getOverlaySize();
+        g_pOptions->stats.nOverlayOffset = ne.getOverlayOffset();
+    } else if ((fileType == XBinary::FT_LE) || (fileType == XBinary::FT_LX)) {
+        XLE le(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+
+        g_pOptions->stats.memoryMap = le.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = le.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+        g_pOptions->stats.bIsOverlayPresent = le.isOverlayPresent();
+        g_pOptions->stats.nOverlaySize = le.getOverlaySize();
+        g_pOptions->stats.nOverlayOffset = le.getOverlayOffset();
+    } else if (fileType == XBinary::FT_COM) {
+        XCOM xcom(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+
+        g_pOptions->stats.memoryMap = xcom.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = xcom.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+    } else if ((fileType == XBinary::FT_BINARY16) || (fileType == XBinary::FT_BINARY)) {
+        XBinary binary(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+
+        binary.setArch("8086");
+        binary.setMode(XBinary::MODE_16);
+
+        g_pOptions->stats.memoryMap = binary.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = binary.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+    } else if (fileType == XBinary::FT_BINARY32) {
+        XBinary binary(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+
+        binary.setArch("386");
+        binary.setMode(XBinary::MODE_32);
+
+        g_pOptions->stats.memoryMap = binary.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = binary.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+    } else if (fileType == XBinary::FT_BINARY64) {
+        XBinary binary(g_pDevice, g_pOptions->bIsImage, g_pOptions->nImageBase);
+
+        binary.setArch("AMD64");
+        binary.setMode(XBinary::MODE_64);
+
+        g_pOptions->stats.memoryMap = binary.getMemoryMap();
+        g_pOptions->stats.nEntryPointAddress = binary.getEntryPointAddress(&g_pOptions->stats.memoryMap);
+    }
 
-                        if (g_pOptions->stats.mapVB.count()) {
-                            if (nIterKey == g_pOptions->stats.mapVB.firstKey())  // TODO move outside 'for'
-                            {
-                                //                                nBlockAddress=pOptions->stats.nImageBase;
-                                nBlockAddress = g_pOptions->stats.memoryMap.listRecords.at(0).nAddress;
-                                nBlockOffset = g_pOptions->stats.memoryMap.listRecords.at(0).nOffset;
+    g_pOptions->stats.nImageBase = g_pOptions->stats.memoryMap.nModuleAddress;
+    //        pOptions->stats.nImageSize=XBinary::getTotalVirtualSize(&(pOptions->stats.memoryMap));
+    g_pOptions->stats.nImageSize = g_pOptions->stats.memoryMap.nImageSize;
 
-                                if (nIterKey < (nRegionAddress + nRegionSize)) {
-                                    nBlockSize = iter.key() - g_pOptions->stats.nImageBase;
-                                } else {
-                                    nBlockSize = (nRegionAddress + nRegionSize) - nBlockAddress;
-                                }
-                            } else if (iter == g_pOptions->stats.mapVB.end()) {
-                                nBlockAddress = nCurrentAddress;
-                                nBlockOffset = nCurrentOffset;
+    if (XDisasmArch::getCsArchMode(&(g_pOptions->stats.memoryMap), &(g_pOptions->stats.csarch), &(g_pOptions->stats.csmode))) {
+        if ((g_pOptions->stats.csarch == CS_ARCH_ARM) && (g_pOptions->stats.nEntryPointAddress & 1)) {
+            // Thumb entry points have the low bit set
+            g_pOptions->stats.csmode = (cs_mode)(g_pOptions->stats.csmode | CS_MODE_THUMB);
+            g_pOptions->stats.nEntryPointAddress &= ~((qint64)1);
+        }
+    }
+}
 
-                                nBlockSize = (nRegionAddress + nRegionSize) - nBlockAddress;
-                            } else {
-                                nBlockAddress = nCurrentAddress;
-                                nBlockOffset = nCurrentOffset;
-                                if (nIterKey < (nRegionAddress + nRegionSize)) {
-                                    nBlockSize = iter.key() - nBlockAddress;
-                                } else {
-                                    nBlockSize = (nRegionAddress + nRegionSize) - nBlockAddress;
-                                }
-                            }
-                        } else {
-                            nBlockAddress = nCurrentAddress;
-                            nBlockOffset = nCurrentOffset;
+bool XDisasm::_openHandle() {
+    if (g_disasm_handle == 0) {
+        if (XDisasmArch::openHandle(g_pOptions->stats.csarch, g_pOptions->stats.csmode, XDisasmArch::DP_TRAVERSE, &g_disasm_handle)) {
+            g_pInsn = cs_malloc(g_disasm_handle);
+        }
 
-                            nBlockSize = (nRegionAddress + nRegionSize) - nBlockAddress;
-                        }
+        XDisasmArch::initFlowTable(&g_flowTable, g_pOptions->stats.csarch);
 
-                        qint64 _nAddress = nBlockAddress;
-                        qint64 _nOffset = nBlockOffset;
-                        qint64 _nSize = nBlockSize;
+        g_nReadBufferOffset = 0;
+        g_nReadBufferSize = 0;
+    }
 
-                        if (_nOffset != -1) {
-                            while (_nSize >= 16) {
-                                VIEW_BLOCK record;
-                                record.nAddress = _nAddress;
-                                record.nOffset = _nOffset;
-                                record.nSize = 16;
-                                record.type = VBT_DATABLOCK;
-
-                                if (!g_pOptions->stats.mapVB.contains(_nAddress)) {
-                                    g_pOptions->stats.mapVB.insert(_nAddress, record);
-                                }
+    return (g_disasm_handle != 0);
+}
 
-                                _nSize -= 16;
-                                _nAddress += 16;
-                                _nOffset += 16;
-                            }
-                        } else {
-                            VIEW_BLOCK record;
-                            record.nAddress = _nAddress;
-                            record.nOffset = -1;
-                            record.nSize = _nSize;
-                            record.type = VBT_DATABLOCK;
+void XDisasm::_closeHandle() {
+    if (g_pInsn) {
+        cs_free(g_pInsn, 1);
+        g_pInsn = 0;
+    }
 
-                            if (!g_pOptions->stats.mapVB.contains(_nAddress)) {
-                                g_pOptions->stats.mapVB.insert(_nAddress, record);
-                            }
-                        }
+    if (g_disasm_handle) {
+        cs_close(&g_disasm_handle);
+        g_disasm_handle = 0;
+    }
+}
 
-                        nCurrentAddress = nBlockAddress + nBlockSize;
-                        if (nBlockOffset != -1) {
-                            nCurrentOffset = nBlockOffset + nBlockSize;
-                        }
-                    } else {
-                        nCurrentAddress = vb.nAddress + vb.nSize;
-                        if (nCurrentOffset != -1) {
-                            nCurrentOffset = vb.nOffset + vb.nSize;
-                        }
-                    }
-                }
-            }
-        }
+const char *XDisasm::_readData(qint64 nOffset, qint64 *pnDataSize) {
+    bool bRefill = (nOffset < g_nReadBufferOffset) || (nOffset >= (g_nReadBufferOffset + g_nReadBufferSize));
 
-        //        QMapIterator<qint64,qint64> iDS(stats.mmapDataLabels);
-        //        while(iDS.hasNext())
-        //        {
-        //            iDS.next();
+    if ((!bRefill) && ((nOffset + N_X64_OPCODE_SIZE) > (g_nReadBufferOffset + g_nReadBufferSize))) {
+        // A short buffer already ends at the end of the device
+        bRefill = (g_nReadBufferSize == N_READBUFFER_SIZE);
+    }
 
-        //            qint64 nAddress=iDS.key();
+    if (bRefill) {
+        if (g_baReadBuffer.size() != N_READBUFFER_SIZE) {
+            g_baReadBuffer.resize(N_READBUFFER_SIZE);
+        }
 
-        //            VIEW_BLOCK record;
-        //            record.nOffset=pBinary->addressToOffset(pListMM,nAddress);
-        //            record.nSize=iDS.value();
-        //            record.type=VBT_DATA;
+        g_nReadBufferOffset = nOffset;
+        g_nReadBufferSize = qMax((qint64)0, (qint64)XBinary::read_array(g_pDevice, nOffset, g_baReadBuffer.data(), N_READBUFFER_SIZE));
+    }
 
-        //            if(!stats.mapVB.contains(nAddress))
-        //            {
-        //                stats.mapVB.insert(nAddress,record);
-        //            }
-        //        }
+    *pnDataSize = qBound((qint64)0, (g_nReadBufferOffset + g_nReadBufferSize) - nOffset, (qint64)N_X64_OPCODE_SIZE);
 
-        //        QSetIterator<qint64> iD(stats.stDataLabels);
-        //        while(iD.hasNext()&&(!bStop))
-        //        {
-        //            qint64 nAddress=iD.next();
+    return g_baReadBuffer.constData() + (nOffset - g_nReadBufferOffset);
+}
 
-        //            VIEW_BLOCK record;
-        //            record.nOffset=pBinary->addressToOffset(pListMM,nAddress);
-        //            record.nSize=0;
-        //            record.type=VBT_DATA;
+void XDisasm::processDisasm() {
+    g_bStop = false;
 
-        //            if(!stats.mapVB.contains(nAddress))
-        //            {
-        //                stats.mapVB.insert(nAddress,record);
-        //            }
-        //        }
+    bool bIsInit = g_pOptions->stats.bInit;
 
-        // TODO Check errors
+    if (_initStats()) {
+        _analyze(bIsInit);
     }
+
+    emit processFinished();
 }
 
-void XDisasm::_updatePositions() {
-    qint64 nImageSize = g_pOptions->stats.nImageSize;
-    qint64 nNumberOfVBs = g_pOptions->stats.mapVB.count();
-    qint64 nVBSize = getVBSize(&(g_pOptions->stats.mapVB));
-    g_pOptions->stats.nPositions = nImageSize + nNumberOfVBs - nVBSize;  // TODO
+void XDisasm::processToData() {
+    QMap<qint64, RECORD>::iterator iterRecord = g_pOptions->stats.mapRecords.find(this->g_nStartAddress);
 
-    g_pOptions->stats.mapPositions.clear();
-    // TODO cache
-    qint64 nCurrentAddress = g_pOptions->stats.nImageBase;  // TODO
+    if (iterRecord != g_pOptions->stats.mapRecords.end()) {
+        if (iterRecord.value().type == RECORD_TYPE_OPCODE) {
+            g_pOptions->stats.nNumberOfOpcodes--;
+        }
 
-    for (qint64 i = 0; i < g_pOptions->stats.nPositions; i++) {
-        bool bIsVBPresent = g_pOptions->stats.mapVB.contains(nCurrentAddress);
+        g_pOptions->stats.mapRecords.erase(iterRecord);
+    }
 
-        if (bIsVBPresent) {
-            g_pOptions->stats.mapPositions.insert(i, nCurrentAddress);
+    qint64 nStartAddress = g_nStartAddress;
+
+    _takeXrefIndex();
+
+    QVector<XREF> *pListXrefs = &(g_pOptions->stats.listXrefs);
+    pListXrefs->erase(std::remove_if(pListXrefs->begin(), pListXrefs->end(), [nStartAddress](const XREF &xref) { return xref.nFrom == nStartAddress; }),
+                      pListXrefs->end());
+
+    _adjust();
+    _updatePositions();
+
+    emit processFinished();
+}
+
+void XDisasm::processLinearSweep() {
+    g_bStop = false;
+
+    bool bIsInit = g_pOptions->stats.bInit;
+
+    if (_initStats()) {
+        _loadFingerprints();
+        _openHandle();
+
+        if (!bIsInit) {
+            _disasm(g_pOptions->stats.nEntryPointAddress);
+        }
+
+        _linearSweep();
+
+        _recognizeFunctions();
+        _adjust();
+        _updatePositions();
+
+        g_pOptions->stats.bInit = true;
+
+        _closeHandle();
+    }
+
+    emit processFinished();
+}
+
+void XDisasm::processGapAnalysis() {
+    g_bStop = false;
+
+    bool bIsInit = g_pOptions->stats.bInit;
+
+    if (_initStats()) {
+        _loadFingerprints();
+        _openHandle();
+
+        if (!bIsInit) {
+            _disasm(g_pOptions->stats.nEntryPointAddress);
+        }
+
+        _gapAnalysis();
+
+        _recognizeFunctions();
+        _adjust();
+        _updatePositions();
+
+        g_pOptions->stats.bInit = true;
+
+        _closeHandle();
+    }
+
+    emit processFinished();
+}
+
+void XDisasm::processExportListing() {
+    g_bStop = false;
+
+    bool bIsInit = g_pOptions->stats.bInit;
+
+    if (_initStats()) {
+        if (!bIsInit) {
+            _analyze(false);
+        }
+
+        QFile file;
+        file.setFileName(g_sFileName);
+
+        if (file.open(QIODevice::WriteOnly)) {
+            if (!_exportListing(&file)) {
+                emit errorMessage(QString("%1: %2").arg("Cannot write file").arg(g_sFileName));
+            }
+
+            file.close();
+        } else {
+            emit errorMessage(QString("%1: %2").arg("Cannot open file").arg(g_sFileName));
+        }
+    }
+
+    emit processFinished();
+}
+
+void XDisasm::processExportColumns() {
+    g_bStop = false;
+
+    bool bIsInit = g_pOptions->stats.bInit;
+
+    if (_initStats()) {
+        if (!bIsInit) {
+            _analyze(false);
+        }
+
+        QFile file;
+        file.setFileName(g_sFileName);
+
+        if (file.open(QIODevice::WriteOnly)) {
+            XDisasmColumns columns(&file);
+
+            if ((!columns.write(&(g_pOptions->stats), &g_bStop)) && (!g_bStop)) {
+                emit errorMessage(QString("%1: %2").arg("Cannot write file").arg(g_sFileName));
+            }
+
+            file.close();
+        } else {
+            emit errorMessage(QString("%1: %2").arg("Cannot open file").arg(g_sFileName));
+        }
+    }
+
+    emit processFinished();
+}
+
+void XDisasm::processStream() {
+    g_bStop = false;
+
+    if (!g_pConsumer) {
+        emit errorMessage(QString("%1: %2").arg("Stream").arg("No consumer"));
+    } else if (_initStats()) {
+        _openHandle();
+
+        // One bit per image byte; mapRecords, xrefs and labels are not filled
+        g_baVisited.fill(false, g_pOptions->stats.nImageSize);
+        g_baLabels.fill(false, g_pOptions->stats.nImageSize);
+
+        if (_testAndSet(&g_baLabels, g_pOptions->stats.nEntryPointAddress)) {
+            g_pConsumer->label(g_pOptions->stats.nEntryPointAddress, LABEL_TYPE_ENTRYPOINT);
+        }
+
+        _stream(g_pOptions->stats.nEntryPointAddress);
+
+        if (g_nStartAddress != -1) {
+            _stream(g_nStartAddress);
+        }
+
+        g_baVisited.clear();
+        g_baLabels.clear();
+
+        _closeHandle();
+    }
+
+    emit processFinished();
+}
+
+void XDisasm::processExportFingerprints() {
+    g_bStop = false;
+
+    bool bIsInit = g_pOptions->stats.bInit;
+
+    if (_initStats()) {
+        if (!bIsInit) {
+            _analyze(false);
+        }
+
+        QList<qint64> listAddresses = g_pOptions->stats.stCalls.values();
+
+        if (!g_pOptions->stats.stCalls.contains(g_pOptions->stats.nEntryPointAddress)) {
+            listAddresses.append(g_pOptions->stats.nEntryPointAddress);
+        }
+
+        std::sort(listAddresses.begin(), listAddresses.end());
+
+        QList<FINGERPRINT> listFingerprints = getFingerprints(g_pDevice, &(g_pOptions->stats), &listAddresses, &g_bStop);
+
+        if (!g_bStop) {
+            QFile file;
+            file.setFileName(g_sFileName);
+
+            if (file.open(QIODevice::WriteOnly)) {
+                // name hash size pattern
+                int nNumberOfFingerprints = listFingerprints.count();
+
+                for (int i = 0; (i < nNumberOfFingerprints) && (!g_bStop); i++) {
+                    const FINGERPRINT *pFingerprint = &(listFingerprints.at(i));
+
+                    QString sName = getLabelString(&(g_pOptions->stats), pFingerprint->nAddress);
+
+                    if (sName == "") {
+                        sName = QString("func_%1").arg(pFingerprint->nAddress, 0, 16);
+                    }
+
+                    QString sLine = QString("%1 %2 %3 %4\n")
+                                        .arg(sName, QString("%1").arg(pFingerprint->nHash, 16, 16, QChar('0')), QString::number(pFingerprint->baData.size(), 16),
+                                             getFingerprintPattern(pFingerprint));
+
+                    file.write(sLine.toUtf8());
+                }
+
+                file.close();
+            } else {
+                emit errorMessage(QString("%1: %2").arg("Cannot open file").arg(g_sFileName));
+            }
+        }
+    }
+
+    emit processFinished();
+}
+
+void XDisasm::processRecognizeFunctions() {
+    g_bStop = false;
+
+    bool bIsInit = g_pOptions->stats.bInit;
+
+    if (_initStats()) {
+        _loadFingerprints();
+        _openHandle();
+
+        if (!bIsInit) {
+            _disasm(g_pOptions->stats.nEntryPointAddress);
+        }
+
+        _recognizeFunctions();
+        _adjust();
+        _updatePositions();
+
+        g_pOptions->stats.bInit = true;
+
+        _closeHandle();
+    }
+
+    emit processFinished();
+}
+
+void XDisasm::process() {
+    if (g_dm == DM_DISASM) {
+        processDisasm();
+    } else if (g_dm == DM_TODATA) {
+        processToData();
+    } else if (g_dm == DM_LINEARSWEEP) {
+        processLinearSweep();
+    } else if (g_dm == DM_EXPORTFINGERPRINTS) {
+        processExportFingerprints();
+    } else if (g_dm == DM_RECOGNIZEFUNCTIONS) {
+        processRecognizeFunctions();
+    } else if (g_dm == DM_GAPANALYSIS) {
+        processGapAnalysis();
+    } else if (g_dm == DM_EXPORTLISTING) {
+        processExportListing();
+    } else if (g_dm == DM_EXPORTCOLUMNS) {
+        processExportColumns();
+    } else if (g_dm == DM_STREAM) {
+        processStream();
+    }
+}
+
+void XDisasm::stop() {
+    g_bStop = true;
+}
+
+void XDisasm::setConsumer(XDisasm::CONSUMER *pConsumer) {
+    g_pConsumer = pConsumer;
+}
+
+XDisasm::STATS *XDisasm::getStats() {
+    return &(g_pOptions->stats);
+}
+
+void XDisasm::_addXref(qint64 nFrom, qint64 nTo, XDisasm::XREF_TYPE type) {
+    if ((type != XREF_TYPE_DATA) || XBinary::isAddressValid(&(g_pOptions->stats.memoryMap), nTo)) {
+        XREF xref = {};
+        xref.nFrom = nFrom;
+        xref.nTo = nTo;
+        xref.type = type;
+
+        g_pOptions->stats.listXrefs.append(xref);
+    }
+}
+
+void XDisasm::_buildXrefIndex(QVector<XDisasm::XREF> *pListXrefs, XDisasm::XREF_INDEX *pIndex, bool bIsTo) {
+    // Sorted in place, the list is only a staging area
+    QVector<XREF> &listXrefs = *pListXrefs;
+
+    std::sort(listXrefs.begin(), listXrefs.end(), [bIsTo](const XREF &xrefLeft, const XREF &xrefRight) {
+        qint64 nLeftKey = bIsTo ? xrefLeft.nTo : xrefLeft.nFrom;
+        qint64 nRightKey = bIsTo ? xrefRight.nTo : xrefRight.nFrom;
+        qint64 nLeftValue = bIsTo ? xrefLeft.nFrom : xrefLeft.nTo;
+        qint64 nRightValue = bIsTo ? xrefRight.nFrom : xrefRight.nTo;
+
+        return (nLeftKey < nRightKey) || ((nLeftKey == nRightKey) && (nLeftValue < nRightValue));
+    });
+
+    int nNumberOfXrefs = listXrefs.count();
+
+    pIndex->listKeys.clear();
+    pIndex->listOffsets.clear();
+    pIndex->listAddresses.clear();
+    pIndex->listTypes.clear();
+
+    pIndex->listAddresses.reserve(nNumberOfXrefs);
+    pIndex->listTypes.reserve(nNumberOfXrefs);
+
+    for (int i = 0; i < nNumberOfXrefs; i++) {
+        qint64 nKey = bIsTo ? listXrefs.at(i).nTo : listXrefs.at(i).nFrom;
+
+        if (pIndex->listKeys.isEmpty() || (pIndex->listKeys.last() != nKey)) {
+            pIndex->listKeys.append(nKey);
+            pIndex->listOffsets.append(pIndex->listAddresses.count());
+        }
+
+        pIndex->listAddresses.append(bIsTo ? listXrefs.at(i).nFrom : listXrefs.at(i).nTo);
+        pIndex->listTypes.append(listXrefs.at(i).type);
+    }
+
+    pIndex->listOffsets.append(pIndex->listAddresses.count());
+
+    pIndex->listKeys.squeeze();
+    pIndex->listOffsets.squeeze();
+}
+
+void XDisasm::_takeXrefIndex() {
+    XREF_INDEX *pIndex = &(g_pOptions->stats.xrefsFrom);
+
+    int nNumberOfKeys = pIndex->listKeys.count();
+
+    g_pOptions->stats.listXrefs.reserve(g_pOptions->stats.listXrefs.count() + pIndex->listAddresses.count());
+
+    for (int i = 0; i < nNumberOfKeys; i++) {
+        for (qint32 j = pIndex->listOffsets.at(i); j < pIndex->listOffsets.at(i + 1); j++) {
+            XREF xref = {};
+            xref.nFrom = pIndex->listKeys.at(i);
+            xref.nTo = pIndex->listAddresses.at(j);
+            xref.type = (XREF_TYPE)pIndex->listTypes.at(j);
+
+            g_pOptions->stats.listXrefs.append(xref);
+        }
+    }
+
+    g_pOptions->stats.xrefsFrom = {};
+    g_pOptions->stats.xrefsTo = {};
+}
+
+QList<XDisasm::XREF> XDisasm::_getXrefs(const XDisasm::XREF_INDEX *pIndex, qint64 nAddress, bool bIsTo) {
+    QList<XREF> listResult;
+
+    QVector<qint64>::const_iterator iter = std::lower_bound(pIndex->listKeys.constBegin(), pIndex->listKeys.constEnd(), nAddress);
+
+    if ((iter != pIndex->listKeys.constEnd()) && (*iter == nAddress)) {
+        qint32 nKey = iter - pIndex->listKeys.constBegin();
+
+        for (qint32 i = pIndex->listOffsets.at(nKey); i < pIndex->listOffsets.at(nKey + 1); i++) {
+            XREF xref = {};
+            xref.nFrom = bIsTo ? pIndex->listAddresses.at(i) : nAddress;
+            xref.nTo = bIsTo ? nAddress : pIndex->listAddresses.at(i);
+            xref.type = (XREF_TYPE)pIndex->listTypes.at(i);
+
+            listResult.append(xref);
+        }
+    }
+
+    return listResult;
+}
+
+void XDisasm::_addQueryEntries(qint64 nAddress, quint32 nOpcodeID, const quint64 *pValues, qint32 nNumberOfValues) {
+    QUERY_ENTRY entry = {};
+    entry.nKey = nOpcodeID;
+    entry.nAddress = nAddress;
+
+    g_listOpcodeEntries.append(entry);
+
+    for (qint32 i = 0; i < nNumberOfValues; i++) {
+        entry.nKey = pValues[i];
+
+        g_listValueEntries.append(entry);
+    }
+}
+
+void XDisasm::_buildQueryIndex(QVector<XDisasm::QUERY_ENTRY> *pListEntries, XDisasm::QUERY_INDEX *pIndex) {
+    // Postings of earlier runs are merged with the new ones
+    QVector<QUERY_ENTRY> listEntries;
+    listEntries.reserve(pIndex->listAddresses.count() + pListEntries->count());
+
+    int nNumberOfKeys = pIndex->listKeys.count();
+
+    for (int i = 0; i < nNumberOfKeys; i++) {
+        for (qint32 j = pIndex->listOffsets.at(i); j < pIndex->listOffsets.at(i + 1); j++) {
+            QUERY_ENTRY entry = {};
+            entry.nKey = pIndex->listKeys.at(i);
+            entry.nAddress = pIndex->listAddresses.at(j);
+
+            listEntries.append(entry);
+        }
+    }
+
+    listEntries.append(*pListEntries);
+    pListEntries->clear();
+
+    std::sort(listEntries.begin(), listEntries.end(), [](const QUERY_ENTRY &entryLeft, const QUERY_ENTRY &entryRight) {
+        return (entryLeft.nKey < entryRight.nKey) || ((entryLeft.nKey == entryRight.nKey) && (entryLeft.nAddress < entryRight.nAddress));
+    });
+
+    pIndex->listKeys.clear();
+    pIndex->listOffsets.clear();
+    pIndex->listAddresses.clear();
+
+    int nNumberOfEntries = listEntries.count();
+
+    for (int i = 0; i < nNumberOfEntries; i++) {
+        quint64 nKey = listEntries.at(i).nKey;
+        qint64 nAddress = listEntries.at(i).nAddress;
+
+        if ((i > 0) && (listEntries.at(i - 1).nKey == nKey) && (listEntries.at(i - 1).nAddress == nAddress)) {
+            continue;
+        }
+
+        // Opcodes turned into data by processToData are dropped
+        QMap<qint64, RECORD>::const_iterator iterRecord = g_pOptions->stats.mapRecords.constFind(nAddress);
+
+        if ((iterRecord == g_pOptions->stats.mapRecords.constEnd()) || (iterRecord.value().type != RECORD_TYPE_OPCODE)) {
+            continue;
+        }
+
+        if (pIndex->listKeys.isEmpty() || (pIndex->listKeys.last() != nKey)) {
+            pIndex->listKeys.append(nKey);
+            pIndex->listOffsets.append(pIndex->listAddresses.count());
+        }
+
+        pIndex->listAddresses.append(nAddress);
+    }
+
+    pIndex->listOffsets.append(pIndex->listAddresses.count());
+
+    pIndex->listKeys.squeeze();
+    pIndex->listOffsets.squeeze();
+    pIndex->listAddresses.squeeze();
+}
+
+QList<qint64> XDisasm::_getPostings(const XDisasm::QUERY_INDEX *pIndex, quint64 nKey) {
+    QList<qint64> listResult;
+
+    QVector<quint64>::const_iterator iter = std::lower_bound(pIndex->listKeys.constBegin(), pIndex->listKeys.constEnd(), nKey);
+
+    if ((iter != pIndex->listKeys.constEnd()) && (*iter == nKey)) {
+        qint32 nIndex = iter - pIndex->listKeys.constBegin();
+
+        for (qint32 i = pIndex->listOffsets.at(nIndex); i < pIndex->listOffsets.at(nIndex + 1); i++) {
+            listResult.append(pIndex->listAddresses.at(i));
+        }
+    }
+
+    return listResult;
+}
+
+void XDisasm::_adjust() {
+    g_pOptions->stats.mapVB.clear();
+
+    // Keep every edge once, whatever the number of passes that found it
+    _takeXrefIndex();
+
+    QVector<XREF> *pListXrefs = &(g_pOptions->stats.listXrefs);
+
+    std::sort(pListXrefs->begin(), pListXrefs->end(), [](const XREF &xrefLeft, const XREF &xrefRight) {
+        return (xrefLeft.nFrom < xrefRight.nFrom) || ((xrefLeft.nFrom == xrefRight.nFrom) && (xrefLeft.nTo < xrefRight.nTo)) ||
+               ((xrefLeft.nFrom == xrefRight.nFrom) && (xrefLeft.nTo == xrefRight.nTo) && (xrefLeft.type < xrefRight.type));
+    });
+
+    pListXrefs->erase(std::unique(pListXrefs->begin(), pListXrefs->end(),
+                                  [](const XREF &xrefLeft, const XREF &xrefRight) {
+                                      return (xrefLeft.nFrom == xrefRight.nFrom) && (xrefLeft.nTo == xrefRight.nTo) && (xrefLeft.type == xrefRight.type);
+                                  }),
+                      pListXrefs->end());
+
+    _buildXrefIndex(pListXrefs, &(g_pOptions->stats.xrefsTo), true);
+    _buildXrefIndex(pListXrefs, &(g_pOptions->stats.xrefsFrom), false);
+
+    // The indexes hold every edge now
+    pListXrefs->clear();
+    pListXrefs->squeeze();
+
+    _buildQueryIndex(&g_listOpcodeEntries, &(g_pOptions->stats.opcodeIndex));
+    _buildQueryIndex(&g_listValueEntries, &(g_pOptions->stats.valueIndex));
+
+    // Named labels are kept, generated ones are only a type and are set again
+    QMutableMapIterator<qint64, LABEL> iLabels(g_pOptions->stats.mapLabels);
+    while (iLabels.hasNext()) {
+        iLabels.next();
+
+        if (iLabels.value().nName == -1) {
+            iLabels.remove();
+        }
+    }
+
+    if (!g_bStop) {
+        if (!g_pOptions->stats.mapLabels.contains(g_pOptions->stats.nEntryPointAddress)) {
+            addLabel(&(g_pOptions->stats), g_pOptions->stats.nEntryPointAddress, LABEL_TYPE_ENTRYPOINT);
+        }
+
+        QSetIterator<qint64> iFL(g_pOptions->stats.stCalls);
+        while (iFL.hasNext() && (!g_bStop)) {
+            qint64 nAddress = iFL.next();
+
+            if (!g_pOptions->stats.mapLabels.contains(nAddress)) {
+                addLabel(&(g_pOptions->stats), nAddress, LABEL_TYPE_FUNCTION);
+            }
+        }
+
+        QSetIterator<qint64> iJL(g_pOptions->stats.stJumps);
+        while (iJL.hasNext() && (!g_bStop)) {
+            qint64 nAddress = iJL.next();
+
+            if (!g_pOptions->stats.mapLabels.contains(nAddress)) {
+                addLabel(&(g_pOptions->stats), nAddress, LABEL_TYPE_JUMP);
+            }
+        }
+
+        //    QSet<qint64> stFunctionLabels;
+        //    QSet<qint64> stJmpLabels;
+        //    QMap<qint64,qint64> mapDataSizeLabels; // Set Max
+        //    QSet<qint64> stDataLabels;
+
+        _findStrings();
+
+        QMapIterator<qint64, XDisasm::RECORD> iRecords(g_pOptions->stats.mapRecords);
+        while (iRecords.hasNext() && (!g_bStop)) {
+            iRecords.next();
+
+            qint64 nAddress = iRecords.key();
+
+            VIEW_BLOCK record;
+            record.nAddress = nAddress;
+            record.nOffset = iRecords.value().nOffset;
+            record.nSize = iRecords.value().nSize;
+
+            if (iRecords.value().type == RECORD_TYPE_OPCODE) {
+                record.type = VBT_OPCODE;
+            } else if (iRecords.value().type == RECORD_TYPE_DATA) {
+                record.type = VBT_DATA;
+            }
+
+            record.dataType = iRecords.value().dataType;
+
+            if ((record.dataType == DT_ANSISTRING) || (record.dataType == DT_UNICODESTRING)) {
+                if (!g_pOptions->stats.mapLabels.contains(nAddress)) {
+                    addLabel(&(g_pOptions->stats), nAddress, LABEL_TYPE_STRING);
+                }
+            }
+
+            if (!g_pOptions->stats.mapVB.contains(nAddress)) {
+                g_pOptions->stats.mapVB.insert(nAddress, record);
+            }
+        }
+
+        int nNumberOfRecords = g_pOptions->stats.memoryMap.listRecords.count();  // TODO
+
+        for (int i = 0; (i < nNumberOfRecords) && (!g_bStop); i++) {
+            qint64 nRegionAddress = g_pOptions->stats.memoryMap.listRecords.at(i).nAddress;
+            qint64 nRegionOffset = g_pOptions->stats.memoryMap.listRecords.at(i).nOffset;
+            qint64 nRegionSize = g_pOptions->stats.memoryMap.listRecords.at(i).nSize;
+
+            if (nRegionAddress != -1) {
+                for (qint64 nCurrentAddress = nRegionAddress, nCurrentOffset = nRegionOffset;
+                     (nCurrentAddress < (nRegionAddress + nRegionSize)) && (!g_bStop);) {
+                    VIEW_BLOCK vb = g_pOptions->stats.mapVB.value(nCurrentAddress);
+
+                    if (!vb.nSize) {
+                        QMap<qint64, VIEW_BLOCK>::const_iterator iter = g_pOptions->stats.mapVB.lowerBound(nCurrentAddress);
+
+                        qint64 nBlockAddress = 0;
+                        qint64 nBlockOffset = 0;
+                        qint64 nBlockSize = 0;
+
+                        qint64 nIterKey = iter.key();
+
+                        if (g_pOptions->stats.mapVB.count()) {
+                            if (nIterKey == g_pOptions->stats.mapVB.firstKey())  // TODO move outside 'for'
+                            {
+                                //                                nBlockAddress=pOptions->stats.nImageBase;
+                                nBlockAddress = g_pOptions->stats.memoryMap.listRecords.at(0).nAddress;
+                                nBlockOffset = g_pOptions->stats.memoryMap.listRecords.at(0).nOffset;
+
+                                if (nIterKey < (nRegionAddress + nRegionSize)) {
+                                    nBlockSize = iter.key() - g_pOptions->stats.nImageBase;
+                                } else {
+                                    nBlockSize = (nRegionAddress + nRegionSize) - nBlockAddress;
+                                }
+                            } else if (iter == g_pOptions->stats.mapVB.end()) {
+                                nBlockAddress = nCurrentAddress;
+                                nBlockOffset = nCurrentOffset;
+
+                                nBlockSize = (nRegionAddress + nRegionSize) - nBlockAddress;
+                            } else {
+                                nBlockAddress = nCurrentAddress;
+                                nBlockOffset = nCurrentOffset;
+                                if (nIterKey < (nRegionAddress + nRegionSize)) {
+                                    nBlockSize = iter.key() - nBlockAddress;
+                                } else {
+                                    nBlockSize = (nRegionAddress + nRegionSize) - nBlockAddress;
+                                }
+                            }
+                        } else {
+                            nBlockAddress = nCurrentAddress;
+                            nBlockOffset = nCurrentOffset;
+
+                            nBlockSize = (nRegionAddress + nRegionSize) - nBlockAddress;
+                        }
+
+                        qint64 _nAddress = nBlockAddress;
+                        qint64 _nOffset = nBlockOffset;
+                        qint64 _nSize = nBlockSize;
+
+                        if (_nOffset != -1) {
+                            _addDataBlocks(_nAddress, _nOffset, _nSize);
+                        } else {
+                            VIEW_BLOCK record;
+                            record.nAddress = _nAddress;
+                            record.nOffset = -1;
+                            record.nSize = _nSize;
+                            record.type = VBT_DATABLOCK;
+                            record.dataType = DT_UNKNOWN;
+
+                            if (!g_pOptions->stats.mapVB.contains(_nAddress)) {
+                                g_pOptions->stats.mapVB.insert(_nAddress, record);
+                            }
+                        }
+
+                        nCurrentAddress = nBlockAddress + nBlockSize;
+                        if (nBlockOffset != -1) {
+                            nCurrentOffset = nBlockOffset + nBlockSize;
+                        }
+                    } else {
+                        nCurrentAddress = vb.nAddress + vb.nSize;
+                        if (nCurrentOffset != -1) {
+                            nCurrentOffset = vb.nOffset + vb.nSize;
+                        }
+                    }
+                }
+            }
+        }
+
+        //        QMapIterator<qint64,qint64> iDS(stats.mmapDataLabels);
+        //        while(iDS.hasNext())
+        //        {
+        //            iDS.next();
+
+        //            qint64 nAddress=iDS.key();
+
+        //            VIEW_BLOCK record;
+        //            record.nOffset=pBinary->addressToOffset(pListMM,nAddress);
+        //            record.nSize=iDS.value();
+        //            record.type=VBT_DATA;
+
+        //            if(!stats.mapVB.contains(nAddress))
+        //            {
+        //                stats.mapVB.insert(nAddress,record);
+        //            }
+        //        }
+
+        //        QSetIterator<qint64> iD(stats.stDataLabels);
+        //        while(iD.hasNext()&&(!bStop))
+        //        {
+        //            qint64 nAddress=iD.next();
+
+        //            VIEW_BLOCK record;
+        //            record.nOffset=pBinary->addressToOffset(pListMM,nAddress);
+        //            record.nSize=0;
+        //            record.type=VBT_DATA;
+
+        //            if(!stats.mapVB.contains(nAddress))
+        //            {
+        //                stats.mapVB.insert(nAddress,record);
+        //            }
+        //        }
+
+        // TODO Check errors
+    }
+}
+
+void XDisasm::_updatePositions() {
+    qint64 nImageSize = g_pOptions->stats.nImageSize;
+    qint64 nNumberOfVBs = g_pOptions->stats.mapVB.count();
+    qint64 nVBSize = getVBSize(&(g_pOptions->stats.mapVB));
+    g_pOptions->stats.nPositions = nImageSize + nNumberOfVBs - nVBSize;  // TODO
+
+    g_pOptions->stats.mapPositions.clear();
+    g_pOptions->stats.mapAddresses.clear();
+    // TODO cache
+    qint64 nCurrentAddress = g_pOptions->stats.nImageBase;  // TODO
+
+    for (qint64 i = 0; i < g_pOptions->stats.nPositions; i++) {
+        bool bIsVBPresent = g_pOptions->stats.mapVB.contains(nCurrentAddress);
+
+        if (bIsVBPresent) {
+            g_pOptions->stats.mapPositions.insert(i, nCurrentAddress);
             g_pOptions->stats.mapAddresses.insert(nCurrentAddress, i);
 
-            nCurrentAddress += g_pOptions->stats.mapVB.value(nCurrentAddress).nSize - 1;
+            nCurrentAddress += g_pOptions->stats.mapVB.value(nCurrentAddress).nSize - 1;
+        }
+
+        nCurrentAddress++;
+    }
+
+    // Every process that changes the records ends here, so the dialogs never build the index on the GUI thread
+    _updateSignatureIndex();
+}
+
+void XDisasm::_updateSignatureIndex() {
+    QList<XBinary::_MEMORY_RECORD> listRegions = getCodeRegions(&(g_pOptions->stats));
+
+    QList<qint64> listAddresses;
+
+    int nNumberOfRegions = listRegions.count();
+
+    for (int i = 0; i < nNumberOfRegions; i++) {
+        listAddresses.append(listRegions.at(i).nAddress);
+    }
+
+    if (g_pOptions->stats.signatureIndex.isEmpty() || (listAddresses != g_pOptions->stats.listSignatureRegions)) {
+        g_pOptions->stats.signatureIndex.clear();
+        g_pOptions->stats.signatureIndex.addRegions(g_pDevice, &listRegions);
+        g_pOptions->stats.signatureIndex.build();
+
+        g_pOptions->stats.listSignatureRegions = listAddresses;
+    }
+}
+
+bool XDisasm::_insertOpcode(qint64 nAddress, XDisasm::RECORD *pOpcode, qint32 nMaxCount) {
+    QMap<qint64, RECORD>::const_iterator iter = g_pOptions->stats.mapRecords.constFind(nAddress);
+
+    if ((iter == g_pOptions->stats.mapRecords.constEnd()) || (iter.value().type != RECORD_TYPE_OPCODE)) {
+        g_pOptions->stats.nNumberOfOpcodes++;
+    }
+
+    g_pOptions->stats.mapRecords.insert(nAddress, *pOpcode);
+
+    return (g_pOptions->stats.nNumberOfOpcodes < nMaxCount);
+}
+
+QList<XBinary::_MEMORY_RECORD> XDisasm::getCodeRegions(STATS *pStats) {
+    QList<XBinary::_MEMORY_RECORD> listResult;
+
+    int nNumberOfRecords = pStats->memoryMap.listRecords.count();
+
+    // The memory map has no protection flags: a region is code if the entry point or a traced opcode is there
+    for (int i = 0; i < nNumberOfRecords; i++) {
+        XBinary::_MEMORY_RECORD record = pStats->memoryMap.listRecords.at(i);
+
+        if ((record.nAddress != -1) && (record.nOffset != -1) && (record.nSize > 0)) {
+            bool bIsCode = (pStats->nEntryPointAddress >= record.nAddress) && (pStats->nEntryPointAddress < (record.nAddress + record.nSize));
+
+            if (!bIsCode) {
+                const QMap<qint64, RECORD> *pMapRecords = &(pStats->mapRecords);
+
+                // A string may precede the first opcode of the region
+                for (QMap<qint64, RECORD>::const_iterator iter = pMapRecords->lowerBound(record.nAddress);
+                     (iter != pMapRecords->constEnd()) && (iter.key() < (record.nAddress + record.nSize)) && (!bIsCode); iter++) {
+                    bIsCode = (iter.value().type == RECORD_TYPE_OPCODE);
+                }
+            }
+
+            if (bIsCode) {
+                listResult.append(record);
+            }
+        }
+    }
+
+    return listResult;
+}
+
+QList<XDisasm::FINGERPRINT> XDisasm::getFingerprints(QIODevice *pDevice, XDisasm::STATS *pStats, QList<qint64> *pListAddresses, bool *pbStop) {
+    QList<FINGERPRINT> listResult;
+
+    QSet<qint64> stFunctions;
+
+    int nNumberOfAddresses = pListAddresses->count();
+
+    for (int i = 0; i < nNumberOfAddresses; i++) {
+        stFunctions.insert(pListAddresses->at(i));
+    }
+
+    for (int i = 0; (i < nNumberOfAddresses) && (!(pbStop && *pbStop)); i++) {
+        FINGERPRINT fingerprint = {};
+        fingerprint.nAddress = pListAddresses->at(i);
+        fingerprint.csarch = pStats->csarch;
+        fingerprint.csmode = pStats->csmode;
+
+        // Instruction bounds are already in the analysis: take the run of opcodes up to the next function
+        qint64 nSize = 0;
+        qint64 nOffset = -1;
+
+        QMap<qint64, RECORD>::const_iterator iter = pStats->mapRecords.constFind(fingerprint.nAddress);
+
+        while ((iter != pStats->mapRecords.constEnd()) && (iter.value().type == RECORD_TYPE_OPCODE) && (iter.key() == (fingerprint.nAddress + nSize)) &&
+               ((nSize + iter.value().nSize) <= N_FINGERPRINT_MAXSIZE)) {
+            if (nSize && stFunctions.contains(iter.key())) {
+                break;
+            }
+
+            if (nOffset == -1) {
+                nOffset = iter.value().nOffset;
+            } else if (iter.value().nOffset != (nOffset + nSize)) {
+                break;
+            }
+
+            fingerprint.listSizes.append((qint32)(iter.value().nSize));
+            nSize += iter.value().nSize;
+
+            iter++;
+        }
+
+        if (nSize) {
+            // The device is read here; workers only see memory
+            fingerprint.baData.resize(nSize);
+
+            if (XBinary::read_array(pDevice, nOffset, fingerprint.baData.data(), nSize) == nSize) {
+                listResult.append(fingerprint);
+            }
+        }
+    }
+
+    if (!(pbStop && *pbStop)) {
+        QtConcurrent::blockingMap(listResult, &XDisasm::_fingerprint);
+    }
+
+    return listResult;
+}
+
+QString XDisasm::getFingerprintPattern(const XDisasm::FINGERPRINT *pFingerprint) {
+    QString sResult;
+
+    const char *pData = pFingerprint->baData.constData();
+    const char *pMask = pFingerprint->baMask.constData();
+
+    int nSize = qMin(pFingerprint->baData.size(), (int)N_FINGERPRINT_PATTERNSIZE);
+
+    for (int i = 0; i < nSize; i++) {
+        if (pMask[i]) {
+            sResult += QString("%1").arg((quint8)pData[i], 2, 16, QChar('0'));
+        } else {
+            sResult += QString("..");
+        }
+    }
+
+    return sResult;
+}
+
+void XDisasm::_fingerprint(XDisasm::FINGERPRINT &fingerprint) {
+    int nSize = fingerprint.baData.size();
+
+    fingerprint.baMask.fill((char)0xFF, nSize);
+
+    const quint8 *pData = (const quint8 *)fingerprint.baData.constData();
+    char *pMask = fingerprint.baMask.data();
+
+    // Displacements and immediates change with the load address and relocations
+    if (fingerprint.csarch == CS_ARCH_X86) {
+        qint32 nOffset = 0;
+        int nNumberOfInstructions = fingerprint.listSizes.count();
+
+        for (int i = 0; i < nNumberOfInstructions; i++) {
+            qint32 nInsnSize = fingerprint.listSizes.at(i);
+
+            XDisasmArch::X86_ENCODING encoding = {};
+
+            if (XDisasmArch::getX86Encoding(pData + nOffset, nInsnSize, fingerprint.csmode, &encoding)) {
+                if (encoding.nDispSize) {
+                    XBinary::_zeroMemory(pMask + nOffset + encoding.nDispOffset, encoding.nDispSize);
+                }
+
+                if (encoding.nImmSize) {
+                    XBinary::_zeroMemory(pMask + nOffset + encoding.nImmOffset, encoding.nImmSize);
+                }
+            }
+
+            nOffset += nInsnSize;
+        }
+    }
+
+    // FNV-1a over the masked bytes
+    quint64 nHash = 14695981039346656037ULL;
+
+    for (int i = 0; i < nSize; i++) {
+        nHash ^= (quint8)(pData[i] & pMask[i]);
+        nHash *= 1099511628211ULL;
+    }
+
+    fingerprint.nHash = nHash;
+}
+
+void XDisasm::_loadFingerprints() {
+    if ((g_pOptions->sFingerprintDatabase != "") && g_fingerprints.isEmpty()) {
+        if (!g_fingerprints.load(g_pOptions->sFingerprintDatabase)) {
+            emit errorMessage(QString("%1: %2").arg("Cannot open file").arg(g_pOptions->sFingerprintDatabase));
+        }
+    }
+}
+
+bool XDisasm::_isLibraryFunction(qint64 nAddress) {
+    bool bResult = false;
+
+    if (g_pOptions->bSkipLibraryFunctions && (!g_fingerprints.isEmpty())) {
+        QHash<qint64, bool>::const_iterator iter = g_mapLibraryFunctions.constFind(nAddress);
+
+        if (iter != g_mapLibraryFunctions.constEnd()) {
+            bResult = iter.value();
+        } else if (g_pOptions->stats.mapLabels.value(nAddress).type == LABEL_TYPE_LIBRARY) {
+            bResult = true;
+        } else {
+            qint64 nOffset = XBinary::addressToOffset(&(g_pOptions->stats.memoryMap), nAddress);
+
+            if (nOffset != -1) {
+                char data[N_FINGERPRINT_PATTERNSIZE];
+
+                qint64 nDataSize = XBinary::read_array(g_pDevice, nOffset, data, N_FINGERPRINT_PATTERNSIZE);
+
+                if (nDataSize > 0) {
+                    QList<qint32> listCandidates = g_fingerprints.getCandidates(data, nDataSize);
+
+                    // The extent is not known yet, so the bytes read must cover each whole pattern and all of them must name one function
+                    QString sName;
+
+                    int nNumberOfCandidates = listCandidates.count();
+
+                    for (int i = 0; i < nNumberOfCandidates; i++) {
+                        XDisasmFingerprints::ENTRY entry = g_fingerprints.getEntry(listCandidates.at(i));
+
+                        if ((entry.nPatternSize > nDataSize) || ((sName != "") && (sName != entry.sName))) {
+                            sName = "";
+                            break;
+                        }
+
+                        sName = entry.sName;
+                    }
+
+                    if (sName != "") {
+                        addLabel(&(g_pOptions->stats), nAddress, LABEL_TYPE_LIBRARY, sName);
+
+                        bResult = true;
+                    }
+                }
+            }
+        }
+
+        g_mapLibraryFunctions.insert(nAddress, bResult);
+    }
+
+    return bResult;
+}
+
+void XDisasm::_recognizeFunctions() {
+    if ((!g_fingerprints.isEmpty()) && (!g_bStop)) {
+        QList<qint64> listAddresses = g_pOptions->stats.stCalls.values();
+
+        if (!g_pOptions->stats.stCalls.contains(g_pOptions->stats.nEntryPointAddress)) {
+            listAddresses.append(g_pOptions->stats.nEntryPointAddress);
+        }
+
+        std::sort(listAddresses.begin(), listAddresses.end());
+
+        QList<FINGERPRINT> listFingerprints = getFingerprints(g_pDevice, &(g_pOptions->stats), &listAddresses, &g_bStop);
+
+        int nNumberOfFingerprints = listFingerprints.count();
+
+        for (int i = 0; (i < nNumberOfFingerprints) && (!g_bStop); i++) {
+            const FINGERPRINT *pFingerprint = &(listFingerprints.at(i));
+
+            if (g_pOptions->stats.mapLabels.value(pFingerprint->nAddress).type != LABEL_TYPE_LIBRARY) {
+                // The trie narrows the database to a few entries, size and hash confirm one of them
+                QList<qint32> listCandidates = g_fingerprints.getCandidates(pFingerprint->baData.constData(), pFingerprint->baData.size());
+
+                int nNumberOfCandidates = listCandidates.count();
+
+                for (int j = 0; j < nNumberOfCandidates; j++) {
+                    XDisasmFingerprints::ENTRY entry = g_fingerprints.getEntry(listCandidates.at(j));
+
+                    if ((entry.nSize == pFingerprint->baData.size()) && (entry.nHash == pFingerprint->nHash)) {
+                        addLabel(&(g_pOptions->stats), pFingerprint->nAddress, LABEL_TYPE_LIBRARY, entry.sName);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+quint64 XDisasm::_getZeroMask(quint64 nValue) {
+    // 0x80 in every byte that is zero, exact, no borrow between bytes
+    quint64 nLow = nValue & 0x7F7F7F7F7F7F7F7FULL;
+
+    return ~((nLow + 0x7F7F7F7F7F7F7F7FULL) | nValue) & 0x8080808080808080ULL;
+}
+
+quint64 XDisasm::_getPrintableMask(quint64 nValue) {
+    // 0x80 in every byte from 0x20 to 0x7E, or tab, LF, CR
+    quint64 nLow = nValue & 0x7F7F7F7F7F7F7F7FULL;
+    quint64 nResult = (~nValue) & (nLow + 0x6060606060606060ULL) & (~(nLow + 0x0101010101010101ULL)) & 0x8080808080808080ULL;
+
+    nResult |= _getZeroMask(nValue ^ 0x0909090909090909ULL);
+    nResult |= _getZeroMask(nValue ^ 0x0A0A0A0A0A0A0A0AULL);
+    nResult |= _getZeroMask(nValue ^ 0x0D0D0D0D0D0D0D0DULL);
+
+    return nResult;
+}
+
+void XDisasm::_findStrings() {
+    QByteArray baBuffer;
+    baBuffer.resize(N_STRING_CHUNKSIZE + 8);
+    baBuffer.fill(0);
+
+    char *pBuffer = baBuffer.data();
+
+    int nNumberOfRecords = g_pOptions->stats.memoryMap.listRecords.count();
+
+    for (int i = 0; (i < nNumberOfRecords) && (!g_bStop); i++) {
+        qint64 nRegionAddress = g_pOptions->stats.memoryMap.listRecords.at(i).nAddress;
+        qint64 nRegionOffset = g_pOptions->stats.memoryMap.listRecords.at(i).nOffset;
+        qint64 nRegionSize = g_pOptions->stats.memoryMap.listRecords.at(i).nSize;
+
+        if ((nRegionAddress == -1) || (nRegionOffset == -1)) {
+            continue;
+        }
+
+        // UTF-16 characters are taken at even addresses only
+        bool bIsUnicode = !(nRegionAddress & 1);
+
+        // Runs are carried over chunks, -1 - no run
+        qint64 nAnsiStart = -1;
+        qint64 nUnicodeStart = -1;
+
+        for (qint64 nChunk = 0; (nChunk < nRegionSize) && (!g_bStop); nChunk += N_STRING_CHUNKSIZE) {
+            qint64 nChunkSize = XBinary::read_array(g_pDevice, nRegionOffset + nChunk, pBuffer, qMin((qint64)N_STRING_CHUNKSIZE, nRegionSize - nChunk));
+
+            if (nChunkSize <= 0) {
+                break;
+            }
+
+            for (qint64 j = 0; j < nChunkSize; j += 8) {
+                qint32 nWordSize = qMin((qint64)8, nChunkSize - j);
+
+                if (nWordSize < 8) {
+                    XBinary::_zeroMemory(pBuffer + j + nWordSize, 8 - nWordSize);
+                }
+
+                quint64 nValue = qFromLittleEndian<quint64>((const uchar *)(pBuffer + j));
+                quint64 nPrintableMask = _getPrintableMask(nValue);
+                quint64 nZeroMask = _getZeroMask(nValue);
+
+                // Whole words inside or outside a run need no per-byte work
+                bool bAnsiWord = (nWordSize == 8) && (((nAnsiStart != -1) && (nPrintableMask == 0x8080808080808080ULL)) ||
+                                                      ((nAnsiStart == -1) && (nPrintableMask == 0)));
+
+                quint64 nUnicodeMask = (nPrintableMask & 0x0080008000800080ULL) | (nZeroMask & 0x8000800080008000ULL);
+
+                bool bUnicodeWord = (!bIsUnicode) || ((nWordSize == 8) && (((nUnicodeStart != -1) && (nUnicodeMask == 0x8080808080808080ULL)) ||
+                                                                           ((nUnicodeStart == -1) && ((nUnicodeMask & 0x0080008000800080ULL) == 0))));
+
+                if (!bAnsiWord) {
+                    for (qint32 k = 0; k < nWordSize; k++) {
+                        qint64 nCurrent = nChunk + j + k;
+
+                        if ((nPrintableMask >> (k * 8 + 7)) & 1) {
+                            if (nAnsiStart == -1) {
+                                nAnsiStart = nCurrent;
+                            }
+                        } else if (nAnsiStart != -1) {
+                            if (((nZeroMask >> (k * 8 + 7)) & 1) && ((nCurrent - nAnsiStart) >= N_STRING_MINSIZE)) {
+                                _insertString(nRegionAddress + nAnsiStart, nRegionOffset + nAnsiStart, nCurrent - nAnsiStart + 1, DT_ANSISTRING);
+                            }
+
+                            nAnsiStart = -1;
+                        }
+                    }
+                }
+
+                if (!bUnicodeWord) {
+                    for (qint32 k = 0; k < nWordSize; k += 2) {
+                        qint64 nCurrent = nChunk + j + k;
+
+                        if ((k + 1) >= nWordSize) {
+                            nUnicodeStart = -1;
+                        } else if (((nPrintableMask >> (k * 8 + 7)) & 1) && ((nZeroMask >> (k * 8 + 15)) & 1)) {
+                            if (nUnicodeStart == -1) {
+                                nUnicodeStart = nCurrent;
+                            }
+                        } else if (nUnicodeStart != -1) {
+                            if (((nZeroMask >> (k * 8 + 7)) & 1) && ((nZeroMask >> (k * 8 + 15)) & 1) && ((nCurrent - nUnicodeStart) >= (2 * N_STRING_MINSIZE))) {
+                                _insertString(nRegionAddress + nUnicodeStart, nRegionOffset + nUnicodeStart, nCurrent - nUnicodeStart + 2, DT_UNICODESTRING);
+                            }
+
+                            nUnicodeStart = -1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void XDisasm::_insertString(qint64 nAddress, qint64 nOffset, qint64 nSize, XDisasm::DT dataType) {
+    bool bOverlap = false;
+
+    // Code and earlier strings take priority
+    QMap<qint64, RECORD>::iterator iter = g_pOptions->stats.mapRecords.lowerBound(nAddress);
+
+    if (iter != g_pOptions->stats.mapRecords.end()) {
+        bOverlap = (iter.key() < (nAddress + nSize));
+    }
+
+    if ((!bOverlap) && (iter != g_pOptions->stats.mapRecords.begin())) {
+        iter--;
+        bOverlap = ((iter.key() + iter.value().nSize) > nAddress);
+    }
+
+    if (!bOverlap) {
+        RECORD record = {};
+        record.nOffset = nOffset;
+        record.nSize = nSize;
+        record.type = RECORD_TYPE_DATA;
+        record.dataType = dataType;
+
+        g_pOptions->stats.mapRecords.insert(nAddress, record);
+    }
+}
+
+void XDisasm::_removeDataRecords(qint64 nAddress, qint64 nSize) {
+    QMap<qint64, RECORD>::iterator iter = g_pOptions->stats.mapRecords.lowerBound(nAddress);
+
+    if (iter != g_pOptions->stats.mapRecords.begin()) {
+        QMap<qint64, RECORD>::iterator iterPrev = iter - 1;
+
+        if ((iterPrev.value().type == RECORD_TYPE_DATA) && ((iterPrev.key() + iterPrev.value().nSize) > nAddress)) {
+            g_pOptions->stats.mapRecords.erase(iterPrev);
+        }
+    }
+
+    while ((iter != g_pOptions->stats.mapRecords.end()) && (iter.key() < (nAddress + nSize))) {
+        if (iter.value().type == RECORD_TYPE_DATA) {
+            iter = g_pOptions->stats.mapRecords.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+}
+
+qint64 XDisasm::_getRepeatSize(const char *pData, qint64 nSize) {
+    qint64 nResult = 0;
+
+    if (nSize > 0) {
+        quint64 nPattern = (quint8)(pData[0]) * 0x0101010101010101ULL;
+
+        while (((nResult + 8) <= nSize) && (qFromLittleEndian<quint64>((const uchar *)(pData + nResult)) == nPattern)) {
+            nResult += 8;
+        }
+
+        while ((nResult < nSize) && (pData[nResult] == pData[0])) {
+            nResult++;
+        }
+    }
+
+    return nResult;
+}
+
+void XDisasm::_addDataBlocks(qint64 nAddress, qint64 nOffset, qint64 nSize) {
+    qint32 nPointerSize = (g_pOptions->stats.csmode & CS_MODE_64) ? 8 : 4;
+
+    QByteArray baBuffer;
+    baBuffer.resize(N_DATA_CHUNKSIZE);
+
+    char *pBuffer = baBuffer.data();
+
+    // A run is cut at the chunk border, the next chunk goes on with a new block
+    for (qint64 nChunk = 0; (nChunk < nSize) && (!g_bStop); nChunk += N_DATA_CHUNKSIZE) {
+        qint64 nChunkSize = qMin((qint64)N_DATA_CHUNKSIZE, nSize - nChunk);
+
+        if (XBinary::read_array(g_pDevice, nOffset + nChunk, pBuffer, nChunkSize) != nChunkSize) {
+            XBinary::_zeroMemory(pBuffer, nChunkSize);
+        }
+
+        for (qint64 i = 0; i < nChunkSize;) {
+            qint64 nCurrentAddress = nAddress + nChunk + i;
+            const char *pData = pBuffer + i;
+            qint64 nRemain = nChunkSize - i;
+
+            VIEW_BLOCK record = {};
+            record.nAddress = nCurrentAddress;
+            record.nOffset = nOffset + nChunk + i;
+            record.type = VBT_DATA;
+            record.dataType = DT_UNKNOWN;
+
+            record.nSize = _getRepeatSize(pData, nRemain);
+
+            if (record.nSize >= N_DATA_REPEATSIZE) {
+                record.dataType = DT_REPEAT;
+            }
+
+            if ((record.dataType == DT_UNKNOWN) && (!(nCurrentAddress % nPointerSize))) {
+                qint64 nCount = 0;
+
+                while (((nCount + 1) * nPointerSize) <= nRemain) {
+                    const uchar *pItem = (const uchar *)(pData + nCount * nPointerSize);
+
+                    qint64 nValue = (nPointerSize == 8) ? qFromLittleEndian<qint64>(pItem) : qFromLittleEndian<quint32>(pItem);
+
+                    if ((!nValue) || (!XBinary::isAddressValid(&(g_pOptions->stats.memoryMap), nValue))) {
+                        break;
+                    }
+
+                    nCount++;
+                }
+
+                if (nCount >= 2) {
+                    record.nSize = nCount * nPointerSize;
+                    record.dataType = (nPointerSize == 8) ? DT_POINTER64 : DT_POINTER32;
+                }
+            }
+
+            // Small integers, a qword array would also pass as dwords so it goes first
+            for (qint32 nItemSize = 8; (nItemSize >= 4) && (record.dataType == DT_UNKNOWN); nItemSize -= 4) {
+                if (!(nCurrentAddress % nItemSize)) {
+                    qint64 nCount = 0;
+
+                    while (((nCount + 1) * nItemSize) <= nRemain) {
+                        const uchar *pItem = (const uchar *)(pData + nCount * nItemSize);
+
+                        quint64 nValue = (nItemSize == 8) ? qFromLittleEndian<quint64>(pItem) : qFromLittleEndian<quint32>(pItem);
+
+                        if (nValue >> 16) {
+                            break;
+                        }
+
+                        nCount++;
+                    }
+
+                    if ((nCount * nItemSize) >= N_DATA_ARRAYSIZE) {
+                        record.nSize = nCount * nItemSize;
+                        record.dataType = (nItemSize == 8) ? DT_QWORDARRAY : DT_DWORDARRAY;
+                    }
+                }
+            }
+
+            if (record.dataType == DT_UNKNOWN) {
+                record.nSize = qMin(16 - (nCurrentAddress & 15), nRemain);
+                record.type = VBT_DATABLOCK;
+            }
+
+            if (!g_pOptions->stats.mapVB.contains(nCurrentAddress)) {
+                g_pOptions->stats.mapVB.insert(nCurrentAddress, record);
+            }
+
+            i += record.nSize;
+        }
+    }
+}
+
+bool XDisasm::_isInRegions(const QList<XBinary::_MEMORY_RECORD> *pListRegions, qint64 nAddress) {
+    bool bResult = false;
+
+    int nNumberOfRegions = pListRegions->count();
+
+    for (int i = 0; (i < nNumberOfRegions) && (!bResult); i++) {
+        bResult = (nAddress >= pListRegions->at(i).nAddress) && (nAddress < (pListRegions->at(i).nAddress + pListRegions->at(i).nSize));
+    }
+
+    return bResult;
+}
+
+bool XDisasm::_isCodePointer(qint64 nAddress) {
+    bool bResult = false;
+
+    QMap<qint64, RECORD>::const_iterator iter = g_pOptions->stats.mapRecords.lowerBound(nAddress);
+
+    if ((iter != g_pOptions->stats.mapRecords.constEnd()) && (iter.key() == nAddress)) {
+        bResult = (iter.value().type == RECORD_TYPE_OPCODE);
+    } else {
+        bool bInside = false;
+
+        if (iter != g_pOptions->stats.mapRecords.constBegin()) {
+            iter--;
+            bInside = (iter.value().type == RECORD_TYPE_OPCODE) && ((iter.key() + iter.value().nSize) > nAddress);
+        }
+
+        // Instructions of fixed size start aligned; x86 thunks and /O1 code have no alignment
+        qint64 nAlignment = 4;
+
+        if (g_pOptions->stats.csarch == CS_ARCH_X86) {
+            nAlignment = 1;
+        } else if ((g_pOptions->stats.csarch == CS_ARCH_ARM) && (g_pOptions->stats.csmode & CS_MODE_THUMB)) {
+            nAlignment = 2;
+        }
+
+        if ((!bInside) && ((nAddress % nAlignment) == 0)) {
+            // A few instructions must decode before the flow ends
+            bResult = true;
+
+            qint64 nCurrentAddress = nAddress;
+
+            for (int i = 0; (i < N_POINTER_CHECKCOUNT) && bResult; i++) {
+                qint64 nOffset = XBinary::addressToOffset(&(g_pOptions->stats.memoryMap), nCurrentAddress);
+
+                bResult = false;
+
+                if (nOffset != -1) {
+                    qint64 nDataSize = 0;
+                    const char *pData = _readData(nOffset, &nDataSize);
+
+                    const uint8_t *_pData = (const uint8_t *)pData;
+                    size_t _nDataSize = nDataSize;
+                    uint64_t _nAddress = nCurrentAddress;
+
+                    if ((nDataSize > 0) && (!XBinary::_isMemoryZeroFilled((char *)pData, nDataSize)) &&
+                        cs_disasm_iter(g_disasm_handle, &_pData, &_nDataSize, &_nAddress, g_pInsn)) {
+                        bResult = true;
+
+                        if (XDisasmArch::getFlow(&g_flowTable, g_disasm_handle, g_pInsn) & XDisasmArch::FLOW_END) {
+                            break;
+                        }
+
+                        nCurrentAddress += g_pInsn->size;
+                    }
+                }
+            }
+        }
+    }
+
+    return bResult;
+}
+
+quint32 XDisasm::_getPointerHits(const char *pData, qint32 nPointerSize, quint64 nMinAddress, quint64 nRange) {
+    quint32 nResult = 0;
+
+    // No branches in the loops, so the compiler vectorises them; a wrapped subtraction makes the range one compare
+    if (nPointerSize == 8) {
+        for (int i = 0; i < N_POINTER_BLOCKSIZE; i++) {
+            quint64 nValue = qFromLittleEndian<quint64>((const uchar *)(pData + i * 8));
+
+            nResult |= ((quint32)((nValue - nMinAddress) < nRange)) << i;
+        }
+    } else {
+        for (int i = 0; i < N_POINTER_BLOCKSIZE; i++) {
+            quint64 nValue = qFromLittleEndian<quint32>((const uchar *)(pData + i * 4));
+
+            nResult |= ((quint32)((nValue - nMinAddress) < nRange)) << i;
+        }
+    }
+
+    return nResult;
+}
+
+void XDisasm::_discoverPointers() {
+    QList<XBinary::_MEMORY_RECORD> listCodeRegions = getCodeRegions(&(g_pOptions->stats));
+
+    qint32 nPointerSize = (g_pOptions->stats.csmode & CS_MODE_64) ? 8 : 4;
+
+    QVector<XREF> listCandidates;
+
+    if (g_pOptions->stats.listRelocs.count()) {
+        // Every relocated value is a pointer, only the target has to be checked
+        int nNumberOfRelocs = g_pOptions->stats.listRelocs.count();
+
+        for (int i = 0; (i < nNumberOfRelocs) && (!g_bStop); i++) {
+            qint64 nRelocAddress = g_pOptions->stats.listRelocs.at(i);
+            qint64 nOffset = XBinary::addressToOffset(&(g_pOptions->stats.memoryMap), nRelocAddress);
+
+            uchar data[8];
+
+            if ((nOffset != -1) && (XBinary::read_array(g_pDevice, nOffset, (char *)data, nPointerSize) == nPointerSize)) {
+                qint64 nValue = (nPointerSize == 8) ? qFromLittleEndian<qint64>(data) : qFromLittleEndian<quint32>(data);
+
+                if (_isInRegions(&listCodeRegions, nValue)) {
+                    XREF xref = {};
+                    xref.nFrom = nRelocAddress;
+                    xref.nTo = nValue;
+                    xref.type = XREF_TYPE_DATA;
+
+                    listCandidates.append(xref);
+                }
+            }
+        }
+    } else if (listCodeRegions.count()) {
+        // No relocations: aligned values of the other regions that fall in code
+        quint64 nMinAddress = listCodeRegions.first().nAddress;
+        quint64 nRange = listCodeRegions.last().nAddress + listCodeRegions.last().nSize - nMinAddress;
+        qint32 nBlockSize = N_POINTER_BLOCKSIZE * nPointerSize;
+
+        QByteArray baBuffer;
+        baBuffer.resize(N_DATA_CHUNKSIZE);
+
+        char *pBuffer = baBuffer.data();
+
+        int nNumberOfRecords = g_pOptions->stats.memoryMap.listRecords.count();
+
+        for (int i = 0; (i < nNumberOfRecords) && (!g_bStop); i++) {
+            XBinary::_MEMORY_RECORD record = g_pOptions->stats.memoryMap.listRecords.at(i);
+
+            if ((record.nAddress == -1) || (record.nOffset == -1) || _isInRegions(&listCodeRegions, record.nAddress)) {
+                continue;
+            }
+
+            qint64 nDelta = (nPointerSize - (record.nAddress % nPointerSize)) % nPointerSize;
+
+            for (qint64 nChunk = nDelta; (nChunk < record.nSize) && (!g_bStop); nChunk += N_DATA_CHUNKSIZE) {
+                qint64 nChunkSize = XBinary::read_array(g_pDevice, record.nOffset + nChunk, pBuffer, qMin((qint64)N_DATA_CHUNKSIZE, record.nSize - nChunk));
+
+                for (qint64 j = 0; (j + nPointerSize) <= nChunkSize; j += nBlockSize) {
+                    quint32 nHits = 0;
+
+                    // Whole blocks are range checked at once, the region list is walked only for the slots that pass
+                    if ((j + nBlockSize) <= nChunkSize) {
+                        nHits = _getPointerHits(pBuffer + j, nPointerSize, nMinAddress, nRange);
+                    } else {
+                        for (qint32 k = 0; (j + (k + 1) * nPointerSize) <= nChunkSize; k++) {
+                            const uchar *pItem = (const uchar *)(pBuffer + j + k * nPointerSize);
+
+                            quint64 nValue = (nPointerSize == 8) ? qFromLittleEndian<quint64>(pItem) : qFromLittleEndian<quint32>(pItem);
+
+                            nHits |= ((quint32)((nValue - nMinAddress) < nRange)) << k;
+                        }
+                    }
+
+                    while (nHits) {
+                        qint32 k = qCountTrailingZeroBits(nHits);
+                        const uchar *pItem = (const uchar *)(pBuffer + j + k * nPointerSize);
+
+                        qint64 nValue = (nPointerSize == 8) ? qFromLittleEndian<qint64>(pItem) : qFromLittleEndian<quint32>(pItem);
+
+                        if (_isInRegions(&listCodeRegions, nValue)) {
+                            XREF xref = {};
+                            xref.nFrom = record.nAddress + nChunk + j + k * nPointerSize;
+                            xref.nTo = nValue;
+                            xref.type = XREF_TYPE_DATA;
+
+                            listCandidates.append(xref);
+                        }
+
+                        nHits &= (nHits - 1);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(listCandidates.begin(), listCandidates.end(), [](const XREF &xrefLeft, const XREF &xrefRight) { return xrefLeft.nTo < xrefRight.nTo; });
+
+    // Targets are checked once, then traversed as one batch
+    QList<qint64> listRoots;
+
+    int nNumberOfCandidates = listCandidates.count();
+
+    bool bIsCode = false;
+
+    for (int i = 0; (i < nNumberOfCandidates) && (!g_bStop); i++) {
+        qint64 nTarget = listCandidates.at(i).nTo;
+
+        if ((i == 0) || (listCandidates.at(i - 1).nTo != nTarget)) {
+            bIsCode = _isCodePointer(nTarget);
+
+            if (bIsCode) {
+                listRoots.append(nTarget);
+            }
+        }
+
+        if (bIsCode) {
+            _addXref(listCandidates.at(i).nFrom, nTarget, XREF_TYPE_DATA);
+        }
+    }
+
+    int nNumberOfRoots = listRoots.count();
+
+    for (int i = 0; (i < nNumberOfRoots) && (!g_bStop); i++) {
+        // Pointers into known code are switch cases and the like, not new functions
+        if (!g_pOptions->stats.mapRecords.contains(listRoots.at(i))) {
+            g_pOptions->stats.stCalls.insert(listRoots.at(i));
+
+            _disasm(listRoots.at(i));
+        }
+    }
+}
+
+bool XDisasm::_isPrologue(const char *pData, qint64 nSize, cs_mode csmode) {
+    bool bResult = false;
+
+    const quint8 *_pData = (const quint8 *)pData;
+
+    if (csmode & CS_MODE_64) {
+        if ((nSize >= 4) && (_pData[0] == 0x55) && (_pData[1] == 0x48) && (_pData[2] == 0x89) && (_pData[3] == 0xE5)) {
+            bResult = true;  // push rbp; mov rbp, rsp
+        } else if ((nSize >= 4) && (_pData[0] == 0x48) && (_pData[1] == 0x83) && (_pData[2] == 0xEC)) {
+            bResult = true;  // sub rsp, imm8
+        } else if ((nSize >= 5) && (_pData[0] == 0x48) && (_pData[1] == 0x89) && ((_pData[2] & 0xC7) == 0x44) && (_pData[3] == 0x24)) {
+            bResult = true;  // mov [rsp+disp8], reg
+        } else if ((nSize >= 5) && (_pData[0] == 0x40) && ((_pData[1] & 0xF8) == 0x50) && (_pData[2] == 0x48) && (_pData[3] == 0x83) && (_pData[4] == 0xEC)) {
+            bResult = true;  // push reg; sub rsp, imm8
+        }
+    } else {
+        if ((nSize >= 3) && (_pData[0] == 0x55) && (((_pData[1] == 0x8B) && (_pData[2] == 0xEC)) || ((_pData[1] == 0x89) && (_pData[2] == 0xE5)))) {
+            bResult = true;  // push ebp; mov ebp, esp
+        }
+    }
+
+    return bResult;
+}
+
+void XDisasm::_gapChunk(GAP_CHUNK &chunk) {
+    csh disasm_handle = 0;
+
+    if (XDisasmArch::openHandle(chunk.csarch, chunk.csmode, XDisasmArch::DP_TRAVERSE, &disasm_handle)) {
+        cs_insn *pInsn = cs_malloc(disasm_handle);
+
+        XDisasmArch::FLOW_TABLE flowTable = {};
+        XDisasmArch::initFlowTable(&flowTable, chunk.csarch);
+
+        const char *pBuffer = chunk.baData.constData();
+        qint64 nBufferSize = chunk.baData.size();
+        qint64 nCandidateSize = qMin(chunk.nSize, nBufferSize);
+
+        bool bIsX86 = (chunk.csarch == CS_ARCH_X86);
+        bool bAfterPadding = chunk.bIsGapStart;  // the gap start follows known code
+
+        // Candidates: the first byte after padding and, on x86, prologue patterns
+        for (qint64 i = 0; (i < nCandidateSize) && (!(*(chunk.pbStop)));) {
+            quint8 nByte = pBuffer[i];
+
+            if ((nByte == 0xCC) || (nByte == 0x90) || (nByte == 0x00)) {
+                qint64 nRun = _getRepeatSize(pBuffer + i, nBufferSize - i);
+
+                if (nRun >= 2) {
+                    i += nRun;
+                    bAfterPadding = true;
+
+                    continue;
+                }
+            }
+
+            bool bIsPrologue = bIsX86 && _isPrologue(pBuffer + i, nBufferSize - i, chunk.csmode);
+
+            if (bAfterPadding || bIsPrologue) {
+                GAP_CANDIDATE candidate = {};
+                candidate.nAddress = chunk.nAddress + i;
+                candidate.bIsPrologue = bIsPrologue;
+
+                chunk.listCandidates.append(candidate);
+            }
+
+            bAfterPadding = false;
+            i++;
+
+            if (bIsX86) {
+                // Words with no padding byte and no prologue first byte are skipped whole
+                while ((i + 8) <= nCandidateSize) {
+                    quint64 nValue = qFromLittleEndian<quint64>((const uchar *)(pBuffer + i));
+
+                    quint64 nMask = _getZeroMask(nValue) | _getZeroMask(nValue ^ 0xCCCCCCCCCCCCCCCCULL) | _getZeroMask(nValue ^ 0x9090909090909090ULL) |
+                                    _getZeroMask(nValue ^ 0x5555555555555555ULL) | _getZeroMask(nValue ^ 0x4848484848484848ULL) |
+                                    _getZeroMask(nValue ^ 0x4040404040404040ULL);
+
+                    if (nMask) {
+                        break;
+                    }
+
+                    i += 8;
+                }
+            }
+        }
+
+        // Each candidate is decoded straight on until the first terminator
+        int nNumberOfCandidates = chunk.listCandidates.count();
+
+        for (int i = 0; (i < nNumberOfCandidates) && (!(*(chunk.pbStop))); i++) {
+            GAP_CANDIDATE *pCandidate = &(chunk.listCandidates[i]);
+
+            qint64 nDelta = pCandidate->nAddress - chunk.nAddress;
+
+            const uint8_t *pData = (const uint8_t *)(pBuffer + nDelta);
+            size_t nDataSize = nBufferSize - nDelta;
+            uint64_t nAddress = pCandidate->nAddress;
+
+            bool bValid = true;
+            bool bEnd = false;
+            qint32 nCount = 0;
+
+            while (bValid && (!bEnd) && (nCount < N_GAP_MAXINSTRUCTIONS)) {
+                if ((nDataSize >= 2) && (pData[0] == 0) && (pData[1] == 0)) {
+                    bValid = false;
+                } else if (cs_disasm_iter(disasm_handle, &pData, &nDataSize, &nAddress, pInsn)) {
+                    quint32 nFlow = XDisasmArch::getFlow(&flowTable, disasm_handle, pInsn);
+                    qint64 nTarget = 0;
+
+                    if ((nFlow & (XDisasmArch::FLOW_JUMP | XDisasmArch::FLOW_CALL)) && XDisasmArch::getBranchAddress(chunk.csarch, chunk.csmode, pInsn, &nTarget)) {
+                        // A target must be in the region and not inside a known instruction
+                        if ((nTarget < chunk.nRegionAddress) || (nTarget >= (chunk.nRegionAddress + chunk.nRegionSize))) {
+                            bValid = false;
+                        } else {
+                            QMap<qint64, RECORD>::const_iterator iter = chunk.pMapRecords->upperBound(nTarget);
+
+                            if (iter != chunk.pMapRecords->constBegin()) {
+                                iter--;
+
+                                if ((iter.key() != nTarget) && (iter.value().type == RECORD_TYPE_OPCODE) && ((iter.key() + iter.value().nSize) > nTarget)) {
+                                    bValid = false;
+                                }
+                            }
+                        }
+                    }
+
+                    nCount++;
+
+                    if (nFlow & XDisasmArch::FLOW_END) {
+                        bEnd = true;
+                    }
+                } else {
+                    bValid = false;
+                }
+            }
+
+            pCandidate->nNumberOfInstructions = nCount;
+            pCandidate->bIsValid = bValid && bEnd && (nCount >= (pCandidate->bIsPrologue ? N_GAP_MININSTRUCTIONS : N_GAP_MINPLAININSTRUCTIONS));
+        }
+
+        cs_free(pInsn, 1);
+        cs_close(&disasm_handle);
+    }
+}
+
+void XDisasm::_gapAnalysis() {
+    QList<XBinary::_MEMORY_RECORD> listRegions = getCodeRegions(&(g_pOptions->stats));
+
+    QList<GAP_CHUNK> listChunks;
+
+    int nNumberOfRegions = listRegions.count();
+
+    for (int i = 0; (i < nNumberOfRegions) && (!g_bStop); i++) {
+        qint64 nRegionAddress = listRegions.at(i).nAddress;
+        qint64 nRegionOffset = listRegions.at(i).nOffset;
+        qint64 nRegionSize = listRegions.at(i).nSize;
+
+        // Gaps are the parts of the region with no traced opcode
+        QList<QPair<qint64, qint64>> listGaps;
+
+        qint64 nCurrentAddress = nRegionAddress;
+
+        QMap<qint64, RECORD>::const_iterator iter = g_pOptions->stats.mapRecords.lowerBound(nRegionAddress);
+
+        while ((iter != g_pOptions->stats.mapRecords.constEnd()) && (iter.key() < (nRegionAddress + nRegionSize))) {
+            if (iter.value().type == RECORD_TYPE_OPCODE) {
+                if (iter.key() > nCurrentAddress) {
+                    listGaps.append(qMakePair(nCurrentAddress, iter.key()));
+                }
+
+                nCurrentAddress = qMax(nCurrentAddress, iter.key() + iter.value().nSize);
+            }
+
+            iter++;
+        }
+
+        if (nCurrentAddress < (nRegionAddress + nRegionSize)) {
+            listGaps.append(qMakePair(nCurrentAddress, nRegionAddress + nRegionSize));
+        }
+
+        int nNumberOfGaps = listGaps.count();
+
+        for (int j = 0; (j < nNumberOfGaps) && (!g_bStop); j++) {
+            qint64 nGapAddress = listGaps.at(j).first;
+            qint64 nGapSize = listGaps.at(j).second - nGapAddress;
+
+            for (qint64 nDelta = 0; (nDelta < nGapSize) && (!g_bStop); nDelta += N_LINEARSWEEP_CHUNKSIZE) {
+                GAP_CHUNK chunk = {};
+                chunk.nAddress = nGapAddress + nDelta;
+                chunk.nSize = qMin((qint64)N_LINEARSWEEP_CHUNKSIZE, nGapSize - nDelta);
+                chunk.bIsGapStart = (nDelta == 0);
+                chunk.nRegionAddress = nRegionAddress;
+                chunk.nRegionSize = nRegionSize;
+                chunk.csarch = g_pOptions->stats.csarch;
+                chunk.csmode = g_pOptions->stats.csmode;
+                chunk.pbStop = &g_bStop;
+                chunk.pMapRecords = &(g_pOptions->stats.mapRecords);
+
+                qint64 nReadSize = qMin(chunk.nSize + N_GAP_OVERLAP, nGapSize - nDelta);
+
+                chunk.baData.resize(nReadSize);
+                qint64 nDataSize = XBinary::read_array(g_pDevice, nRegionOffset + (chunk.nAddress - nRegionAddress), chunk.baData.data(), nReadSize);
+                chunk.baData.resize(qMax(nDataSize, (qint64)0));
+
+                listChunks.append(chunk);
+            }
+        }
+    }
+
+    // Workers only read the chunks and the records, the records change after all of them are done
+    QtConcurrent::blockingMap(listChunks, &XDisasm::_gapChunk);
+
+    int nNumberOfChunks = listChunks.count();
+
+    for (int i = 0; (i < nNumberOfChunks) && (!g_bStop); i++) {
+        const QVector<GAP_CANDIDATE> *pListCandidates = &(listChunks.at(i).listCandidates);
+
+        int nNumberOfCandidates = pListCandidates->count();
+
+        for (int j = 0; (j < nNumberOfCandidates) && (!g_bStop); j++) {
+            if (pListCandidates->at(j).bIsValid) {
+                qint64 nAddress = pListCandidates->at(j).nAddress;
+
+                // A candidate inside a function accepted before it is dropped
+                bool bIsCovered = false;
+
+                QMap<qint64, RECORD>::const_iterator iter = g_pOptions->stats.mapRecords.upperBound(nAddress);
+
+                if (iter != g_pOptions->stats.mapRecords.constBegin()) {
+                    iter--;
+
+                    bIsCovered = (iter.value().type == RECORD_TYPE_OPCODE) && ((iter.key() + iter.value().nSize) > nAddress);
+                }
+
+                if (!bIsCovered) {
+                    g_pOptions->stats.stCalls.insert(nAddress);
+
+                    _disasm(nAddress);
+                }
+            }
+        }
+    }
+}
+
+void XDisasm::_linearSweep() {
+    QList<XBinary::_MEMORY_RECORD> listRegions = getCodeRegions(&(g_pOptions->stats));
+
+    int nNumberOfRegions = listRegions.count();
+
+    bool bContinue = true;
+
+    for (int i = 0; (i < nNumberOfRegions) && bContinue && (!g_bStop); i++) {
+        qint64 nRegionAddress = listRegions.at(i).nAddress;
+        qint64 nRegionOffset = listRegions.at(i).nOffset;
+        qint64 nRegionSize = listRegions.at(i).nSize;
+
+        QList<SWEEP_CHUNK> listChunks;
+
+        for (qint64 nDelta = 0; (nDelta < nRegionSize) && (!g_bStop); nDelta += N_LINEARSWEEP_CHUNKSIZE) {
+            SWEEP_CHUNK chunk = {};
+            chunk.nAddress = nRegionAddress + nDelta;
+            chunk.nSize = qMin((qint64)N_LINEARSWEEP_CHUNKSIZE, nRegionSize - nDelta);
+            chunk.csarch = g_pOptions->stats.csarch;
+            chunk.csmode = g_pOptions->stats.csmode;
+            chunk.pbStop = &g_bStop;
+
+            qint64 nReadSize = qMin(chunk.nSize + N_LINEARSWEEP_OVERLAP, nRegionSize - nDelta);
+
+            chunk.baData.resize(nReadSize);
+            qint64 nDataSize = XBinary::read_array(g_pDevice, nRegionOffset + nDelta, chunk.baData.data(), nReadSize);
+            chunk.baData.resize(nDataSize);
+
+            listChunks.append(chunk);
+        }
+
+        // The device is read above; workers only decode memory, each with its own handle
+        QtConcurrent::blockingMap(listChunks, &XDisasm::_sweepChunk);
+
+        // A chunk keeps decoding into the overlap until its stream meets an instruction boundary of the next chunk
+        qint64 nSyncAddress = nRegionAddress;
+
+        int nNumberOfChunks = listChunks.count();
+
+        for (int j = 0; (j < nNumberOfChunks) && bContinue && (!g_bStop); j++) {
+            const QVector<SWEEP_RECORD> *pListRecords = &(listChunks.at(j).listRecords);
+            const QVector<SWEEP_RECORD> *pListNextRecords = 0;
+
+            if ((j + 1) < nNumberOfChunks) {
+                pListNextRecords = &(listChunks.at(j + 1).listRecords);
+            }
+
+            qint64 nChunkEnd = listChunks.at(j).nAddress + listChunks.at(j).nSize;
+
+            int nNumberOfRecords = pListRecords->count();
+
+            for (int k = 0; (k < nNumberOfRecords) && bContinue; k++) {
+                const SWEEP_RECORD *pRecord = &(pListRecords->at(k));
+
+                if (pRecord->nAddress >= nChunkEnd) {
+                    if ((pListNextRecords == 0) || _isSweepBoundary(pListNextRecords, pRecord->nAddress)) {
+                        break;
+                    }
+                }
+
+                if (pRecord->nAddress >= nSyncAddress) {
+                    qint64 nOffset = nRegionOffset + (pRecord->nAddress - nRegionAddress);
+
+                    bContinue = _insertSweepRecord(pRecord, nOffset);
+
+                    nSyncAddress = pRecord->nAddress + pRecord->nSize;
+                }
+            }
+        }
+    }
+
+    if (!bContinue) {
+        emit errorMessage(QString("%1: %2").arg("Linear sweep stopped, opcode limit reached").arg(N_LINEARSWEEP_COUNT));
+    }
+}
+
+void XDisasm::_sweepChunk(SWEEP_CHUNK &chunk) {
+    csh disasm_handle = 0;
+
+    if (XDisasmArch::openHandle(chunk.csarch, chunk.csmode, XDisasmArch::DP_TRAVERSE, &disasm_handle)) {
+        cs_insn *pInsn = cs_malloc(disasm_handle);
+
+        XDisasmArch::FLOW_TABLE flowTable = {};
+        XDisasmArch::initFlowTable(&flowTable, chunk.csarch);
+
+        const uint8_t *pData = (const uint8_t *)chunk.baData.constData();
+        size_t nDataSize = chunk.baData.size();
+        uint64_t nAddress = chunk.nAddress;
+
+        while ((nDataSize > 0) && (!(*(chunk.pbStop)))) {
+            bool bSkip = XBinary::_isMemoryZeroFilled((char *)pData, qMin((qint64)nDataSize, (qint64)N_X64_OPCODE_SIZE));
+
+            if (!bSkip) {
+                if (cs_disasm_iter(disasm_handle, &pData, &nDataSize, &nAddress, pInsn)) {
+                    SWEEP_RECORD record = {};
+                    record.nAddress = pInsn->address;
+                    record.nSize = pInsn->size;
+                    record.nBranchAddress = -1;
+                    record.nDataAddress = -1;
+
+                    quint32 nFlow = XDisasmArch::getFlow(&flowTable, disasm_handle, pInsn);
+
+                    if (nFlow & (XDisasmArch::FLOW_JUMP | XDisasmArch::FLOW_CALL)) {
+                        if (XDisasmArch::getBranchAddress(chunk.csarch, chunk.csmode, pInsn, &(record.nBranchAddress))) {
+                            record.bIsCall = (nFlow & XDisasmArch::FLOW_CALL);
+                        }
+                    }
+
+                    if ((record.nBranchAddress == -1) && (!XDisasmArch::getDataAddress(chunk.csarch, chunk.csmode, pInsn, &(record.nDataAddress)))) {
+                        record.nDataAddress = -1;
+                    }
+
+                    record.nOpcodeID = pInsn->id;
+                    record.nNumberOfValues = XDisasmArch::getOperandValues(chunk.csarch, chunk.csmode, pInsn, record.nValues, N_QUERY_MAXVALUES);
+
+                    chunk.listRecords.append(record);
+                } else {
+                    bSkip = true;
+                }
+            }
+
+            if (bSkip) {
+                // Resync on the next byte
+                pData++;
+                nDataSize--;
+                nAddress++;
+            }
+        }
+
+        cs_free(pInsn, 1);
+        cs_close(&disasm_handle);
+    }
+}
+
+void XDisasm::_listingChunk(XDisasm::LISTING_CHUNK &chunk) {
+    csh disasm_handle = 0;
+    cs_insn *pInsn = nullptr;
+
+    if (XDisasmArch::openHandle(chunk.pStats->csarch, chunk.pStats->csmode, XDisasmArch::DP_DISPLAY, &disasm_handle)) {
+        pInsn = cs_malloc(disasm_handle);
+    }
+
+    QString sText;
+
+    // The const overload does not detach the map shared by the workers
+    const QMap<qint64, VIEW_BLOCK> *pMapVB = &(chunk.pStats->mapVB);
+
+    QMap<qint64, VIEW_BLOCK>::const_iterator iter = pMapVB->lowerBound(chunk.nAddress);
+
+    while ((iter != pMapVB->constEnd()) && (iter.key() < chunk.nEndAddress) && (!(*(chunk.pbStop)))) {
+        VIEW_BLOCK vb = iter.value();
+
+        QString sAddress;
+
+        if (vb.nAddress > 0xFFFFFFFF) {
+            sAddress = XBinary::valueToHex((quint64)vb.nAddress);
+        } else {
+            sAddress = XBinary::valueToHex((quint32)vb.nAddress);
+        }
+
+        QString sBytes;
+        QString sOpcode;
+
+        if (vb.nOffset != -1) {
+            qint64 nDelta = vb.nOffset - chunk.nOffset;
+            qint64 nRowSize = qMin(vb.nSize, chunk.baData.size() - nDelta);
+
+            if ((vb.type != VBT_OPCODE) && (vb.dataType != DT_ANSISTRING) && (vb.dataType != DT_UNICODESTRING)) {
+                nRowSize = qMin(nRowSize, (qint64)N_LISTING_ROWSIZE);
+            }
+
+            if (nRowSize > 0) {
+                QByteArray baRow = chunk.baData.mid(nDelta, nRowSize);
+
+                sBytes = baRow.toHex();
+
+                if (nRowSize < vb.nSize) {
+                    sBytes += "...";
+                }
+
+                if ((vb.type == VBT_OPCODE) && pInsn) {
+                    sOpcode = getOpcodeString(chunk.pStats, disasm_handle, pInsn, vb.nAddress, baRow.data(), baRow.size(), true);
+                } else if (vb.type == VBT_DATA) {
+                    sOpcode = getDataString(chunk.pStats, &vb, &baRow);
+                }
+            }
+        } else {
+            sBytes = QString("byte 0x%1 dup(?)").arg(vb.nSize, 0, 16);
+        }
+
+        QString sLabel = getLabelString(chunk.pStats, vb.nAddress);
+
+        if (sLabel != "") {
+            sText += QString("\n%1:\n").arg(sLabel);
+        }
+
+        sText += QString("%1 %2 %3\n").arg(sAddress, sBytes.leftJustified(2 * N_X64_OPCODE_SIZE), sOpcode);
+
+        iter++;
+    }
+
+    chunk.baText = sText.toUtf8();
+
+    if (pInsn) {
+        cs_free(pInsn, 1);
+    }
+
+    if (disasm_handle) {
+        cs_close(&disasm_handle);
+    }
+}
+
+bool XDisasm::_exportListing(QIODevice *pDevice) {
+    bool bResult = true;
+
+    // Rows are rendered in parallel and written in order; only one batch of chunks is held at a time
+    int nBatchSize = qMax(1, QThread::idealThreadCount()) * N_LISTING_BATCHSIZE;
+
+    QMap<qint64, VIEW_BLOCK>::const_iterator iter = g_pOptions->stats.mapVB.constBegin();
+
+    while ((iter != g_pOptions->stats.mapVB.constEnd()) && bResult && (!g_bStop)) {
+        QList<LISTING_CHUNK> listChunks;
+
+        while ((iter != g_pOptions->stats.mapVB.constEnd()) && (listChunks.count() < nBatchSize)) {
+            LISTING_CHUNK chunk = {};
+            chunk.nAddress = iter.key();
+            chunk.nOffset = iter.value().nOffset;
+            chunk.pStats = &(g_pOptions->stats);
+            chunk.pbStop = &g_bStop;
+
+            qint64 nNextOffset = chunk.nOffset;
+            qint64 nEndAddress = chunk.nAddress;
+            qint32 nNumberOfRows = 0;
+
+            // The bytes of a chunk are one read, so a chunk ends where the file offsets stop following each other
+            while ((iter != g_pOptions->stats.mapVB.constEnd()) && (nNumberOfRows < N_LISTING_CHUNKROWS)) {
+                // A row that would cross the size limit starts the next chunk, only a single large row may exceed it
+                if (nNumberOfRows &&
+                    ((iter.value().nOffset != nNextOffset) || ((nNextOffset + iter.value().nSize - chunk.nOffset) > N_LISTING_CHUNKSIZE))) {
+                    break;
+                }
+
+                if (nNextOffset != -1) {
+                    nNextOffset = iter.value().nOffset + iter.value().nSize;
+                }
+
+                nEndAddress = iter.value().nAddress + iter.value().nSize;
+                nNumberOfRows++;
+
+                iter++;
+            }
+
+            chunk.nEndAddress = nEndAddress;
+
+            if (chunk.nOffset != -1) {
+                qint64 nReadSize = nNextOffset - chunk.nOffset;
+
+                chunk.baData.resize(nReadSize);
+                qint64 nDataSize = XBinary::read_array(g_pDevice, chunk.nOffset, chunk.baData.data(), nReadSize);
+                chunk.baData.resize(qMax(nDataSize, (qint64)0));
+            }
+
+            listChunks.append(chunk);
         }
 
-        nCurrentAddress++;
+        QtConcurrent::blockingMap(listChunks, &XDisasm::_listingChunk);
+
+        int nNumberOfChunks = listChunks.count();
+
+        for (int i = 0; (i < nNumberOfChunks) && bResult && (!g_bStop); i++) {
+            const QByteArray *pbaText = &(listChunks.at(i).baText);
+
+            bResult = (pDevice->write(*pbaText) == pbaText->size());
+        }
     }
+
+    return bResult;
 }
 
-bool XDisasm::_insertOpcode(qint64 nAddress, XDisasm::RECORD *pOpcode) {
-    g_pOptions->stats.mapRecords.insert(nAddress, *pOpcode);
+bool XDisasm::_isSweepBoundary(const QVector<SWEEP_RECORD> *pListRecords, qint64 nAddress) {
+    bool bResult = false;
+
+    int nLow = 0;
+    int nHigh = pListRecords->count() - 1;
+
+    while ((nLow <= nHigh) && (!bResult)) {
+        int nMiddle = (nLow + nHigh) / 2;
+        qint64 nMiddleAddress = pListRecords->at(nMiddle).nAddress;
+
+        if (nMiddleAddress == nAddress) {
+            bResult = true;
+        } else if (nMiddleAddress < nAddress) {
+            nLow = nMiddle + 1;
+        } else {
+            nHigh = nMiddle - 1;
+        }
+    }
+
+    return bResult;
+}
+
+bool XDisasm::_insertSweepRecord(const SWEEP_RECORD *pRecord, qint64 nOffset) {
+    bool bResult = true;
+    bool bOverlap = false;
+
+    // Opcodes of the recursive traversal take priority, guessed strings give way as they do to _disasm
+    QMap<qint64, RECORD>::const_iterator iter = g_pOptions->stats.mapRecords.lowerBound(pRecord->nAddress);
+
+    if (iter != g_pOptions->stats.mapRecords.constBegin()) {
+        iter--;
+
+        if ((iter.key() + iter.value().nSize) <= pRecord->nAddress) {
+            iter++;
+        }
+    }
+
+    while ((iter != g_pOptions->stats.mapRecords.constEnd()) && (iter.key() < (pRecord->nAddress + pRecord->nSize)) && (!bOverlap)) {
+        bOverlap = (iter.value().type == RECORD_TYPE_OPCODE);
+
+        iter++;
+    }
+
+    if (!bOverlap) {
+        _removeDataRecords(pRecord->nAddress, pRecord->nSize);
+
+        RECORD opcode = {};
+        opcode.nOffset = nOffset;
+        opcode.nSize = pRecord->nSize;
+        opcode.type = RECORD_TYPE_OPCODE;
+
+        bResult = _insertOpcode(pRecord->nAddress, &opcode, N_LINEARSWEEP_COUNT);
 
-    int nNumberOfRecords = g_pOptions->stats.mapRecords.count();
+        if (bResult) {
+            _addQueryEntries(pRecord->nAddress, pRecord->nOpcodeID, pRecord->nValues, pRecord->nNumberOfValues);
+        }
+
+        if (pRecord->nBranchAddress != -1) {
+            if (pRecord->bIsCall) {
+                g_pOptions->stats.stCalls.insert(pRecord->nBranchAddress);
+                _addXref(pRecord->nAddress, pRecord->nBranchAddress, XREF_TYPE_CALL);
+            } else {
+                g_pOptions->stats.stJumps.insert(pRecord->nBranchAddress);
+                _addXref(pRecord->nAddress, pRecord->nBranchAddress, XREF_TYPE_JUMP);
+            }
+        } else if (pRecord->nDataAddress != -1) {
+            _addXref(pRecord->nAddress, pRecord->nDataAddress, XREF_TYPE_DATA);
+        }
+    }
 
-    return (nNumberOfRecords < N_OPCODE_COUNT);
+    return bResult;
 }
 
 qint64 XDisasm::getVBSize(QMap<qint64, XDisasm::VIEW_BLOCK> *pMapVB) {
@@ -562,19 +2574,370 @@ qint64 XDisasm::getVBSize(QMap<qint64, XDisasm::VIEW_BLOCK> *pMapVB) {
 QString XDisasm::getDisasmString(csh disasm_handle, qint64 nAddress, char *pData, qint32 nDataSize) {
     QString sResult;
 
-    cs_insn *pInsn = 0;
-    size_t nNumberOfOpcodes = cs_disasm(disasm_handle, (uint8_t *)pData, nDataSize, nAddress, 1, &pInsn);
+    cs_insn *pInsn = cs_malloc(disasm_handle);
+
+    if (pInsn) {
+        sResult = getDisasmString(disasm_handle, pInsn, nAddress, pData, nDataSize);
+
+        cs_free(pInsn, 1);
+    }
+
+    return sResult;
+}
+
+QString XDisasm::getDisasmString(csh disasm_handle, cs_insn *pInsn, qint64 nAddress, char *pData, qint32 nDataSize) {
+    QString sResult;
+
+    const uint8_t *_pData = (const uint8_t *)pData;
+    size_t _nDataSize = nDataSize;
+    uint64_t _nAddress = nAddress;
+
+    if (cs_disasm_iter(disasm_handle, &_pData, &_nDataSize, &_nAddress, pInsn)) {
+        sResult = pInsn->mnemonic;
+
+        if (pInsn->op_str[0]) {
+            sResult += " ";
+            sResult += pInsn->op_str;
+        }
+    }
+
+    return sResult;
+}
+
+QString XDisasm::getOpcodeString(XDisasm::STATS *pStats, csh disasm_handle, cs_insn *pInsn, qint64 nAddress, char *pData, qint32 nDataSize,
+                                 bool bShowLabels) {
+    QString sResult = getDisasmString(disasm_handle, pInsn, nAddress, pData, nDataSize);
+
+    if (bShowLabels) {
+        QList<XREF> listXrefs = getXrefsFrom(pStats, nAddress);
+
+        int nNumberOfXrefs = listXrefs.count();
+
+        for (int i = 0; i < nNumberOfXrefs; i++) {
+            QString sRString = getLabelString(pStats, listXrefs.at(i).nTo);
+
+            if (sRString != "") {
+                QString sAddress = QString("0x%1").arg(listXrefs.at(i).nTo, 0, 16);
+                sResult = sResult.replace(sAddress, sRString);
+            }
+        }
+    }
+
+    return sResult;
+}
+
+QList<XDisasm::SEARCH_CHUNK> XDisasm::getSearchChunks(QIODevice *pDevice, XDisasm::STATS *pStats, QRegularExpression regExp, bool bShowLabels, bool *pbStop) {
+    QList<SEARCH_CHUNK> listResult;
+
+    QString sFileName;
+
+    QFile *pFile = qobject_cast<QFile *>(pDevice);
+
+    if (pFile) {
+        sFileName = pFile->fileName();
+    }
+
+    int nNumberOfRecords = pStats->memoryMap.listRecords.count();
+
+    for (int i = 0; i < nNumberOfRecords; i++) {
+        XBinary::_MEMORY_RECORD record = pStats->memoryMap.listRecords.at(i);
+
+        if ((record.nAddress != -1) && (record.nOffset != -1)) {
+            for (qint64 nDelta = 0; nDelta < record.nSize; nDelta += N_SEARCH_CHUNKSIZE) {
+                SEARCH_CHUNK chunk = {};
+                chunk.pStats = pStats;
+                chunk.regExp = regExp;
+                chunk.bShowLabels = bShowLabels;
+                chunk.nAddress = record.nAddress + nDelta;
+                chunk.nOffset = record.nOffset + nDelta;
+                chunk.nSize = qMin((qint64)N_SEARCH_CHUNKSIZE, record.nSize - nDelta);
+                chunk.sFileName = sFileName;
+                chunk.pbStop = pbStop;
+
+                if (sFileName == "") {
+                    // Memory devices are cheap to read here
+                    chunk.baData.resize(chunk.nSize + N_SEARCH_OVERLAP);
+
+                    qint64 nDataSize = XBinary::read_array(pDevice, chunk.nOffset, chunk.baData.data(), chunk.baData.size());
+
+                    chunk.baData.resize(qMax(nDataSize, (qint64)0));
+                }
+
+                listResult.append(chunk);
+            }
+        }
+    }
+
+    return listResult;
+}
+
+QList<XDisasm::SEARCH_RESULT> XDisasm::searchChunk(const XDisasm::SEARCH_CHUNK &chunk) {
+    QList<SEARCH_RESULT> listResult;
+
+    if (!(*(chunk.pbStop))) {
+        QByteArray baData = chunk.baData;
+
+        if (chunk.sFileName != "") {
+            QFile file;
+            file.setFileName(chunk.sFileName);
+
+            // The overlap covers rows that cross the end of the chunk
+            if (file.open(QIODevice::ReadOnly)) {
+                baData.resize(chunk.nSize + N_SEARCH_OVERLAP);
+
+                qint64 nDataSize = XBinary::read_array(&file, chunk.nOffset, baData.data(), baData.size());
+
+                baData.resize(qMax(nDataSize, (qint64)0));
+
+                file.close();
+            }
+        }
+
+        csh disasm_handle = 0;
+        cs_insn *pInsn = nullptr;
+
+        if (XDisasmArch::openHandle(chunk.pStats->csarch, chunk.pStats->csmode, XDisasmArch::DP_DISPLAY, &disasm_handle)) {
+            pInsn = cs_malloc(disasm_handle);
+        }
+
+        // The const overload does not detach the map shared by the workers
+        const QMap<qint64, VIEW_BLOCK> *pMapVB = &(chunk.pStats->mapVB);
+
+        QMap<qint64, VIEW_BLOCK>::const_iterator iter = pMapVB->lowerBound(chunk.nAddress);
+
+        while ((iter != pMapVB->constEnd()) && (iter.key() < (chunk.nAddress + chunk.nSize)) && (!(*(chunk.pbStop)))) {
+            VIEW_BLOCK vb = iter.value();
+
+            qint64 nDelta = vb.nAddress - chunk.nAddress;
+            qint64 nRowSize = qMin(vb.nSize, baData.size() - nDelta);
+
+            QString sOpcode;
+
+            if (nRowSize > 0) {
+                if ((vb.type == VBT_OPCODE) && pInsn) {
+                    sOpcode = getOpcodeString(chunk.pStats, disasm_handle, pInsn, vb.nAddress, (char *)(baData.constData()) + nDelta, nRowSize, chunk.bShowLabels);
+                } else if (vb.type == VBT_DATA) {
+                    QByteArray baRow = baData.mid(nDelta, nRowSize);
+
+                    sOpcode = getDataString(chunk.pStats, &vb, &baRow);
+                }
+            }
+
+            QString sText = getLabelString(chunk.pStats, vb.nAddress);
+
+            if (sText == "") {
+                sText = sOpcode;
+            } else if (sOpcode != "") {
+                sText = QString("%1: %2").arg(sText, sOpcode);
+            }
+
+            if ((sText != "") && chunk.regExp.match(sText).hasMatch()) {
+                SEARCH_RESULT record = {};
+                record.nAddress = vb.nAddress;
+                record.sText = sText;
+
+                listResult.append(record);
+            }
+
+            iter++;
+        }
+
+        if (pInsn) {
+            cs_free(pInsn, 1);
+        }
+
+        if (disasm_handle) {
+            cs_close(&disasm_handle);
+        }
+    }
+
+    return listResult;
+}
+
+QString XDisasm::getLabelString(XDisasm::STATS *pStats, qint64 nAddress) {
+    QString sResult;
+
+    QMap<qint64, LABEL>::const_iterator iter = pStats->mapLabels.constFind(nAddress);
+
+    if (iter != pStats->mapLabels.constEnd()) {
+        sResult = getLabelString(pStats, nAddress, iter.value());
+    }
+
+    return sResult;
+}
+
+QString XDisasm::getLabelString(XDisasm::STATS *pStats, qint64 nAddress, XDisasm::LABEL label) {
+    QString sResult;
+
+    if (label.nName != -1) {
+        sResult = QString::fromUtf8(pStats->baLabelNames.constData() + label.nName);
+    } else if (label.type == LABEL_TYPE_ENTRYPOINT) {
+        sResult = "entry_point";
+    } else if (label.type == LABEL_TYPE_FUNCTION) {
+        sResult = QString("func_%1").arg(nAddress, 0, 16);
+    } else if (label.type == LABEL_TYPE_JUMP) {
+        sResult = QString("lab_%1").arg(nAddress, 0, 16);
+    } else if (label.type == LABEL_TYPE_STRING) {
+        sResult = QString("str_%1").arg(nAddress, 0, 16);
+    }
+
+    return sResult;
+}
+
+void XDisasm::addLabel(XDisasm::STATS *pStats, qint64 nAddress, XDisasm::LABEL_TYPE type, QString sName) {
+    LABEL label = {};
+    label.type = type;
+    label.nName = -1;
+
+    if (sName != "") {
+        label.nName = pStats->baLabelNames.size();
+
+        pStats->baLabelNames.append(sName.toUtf8());
+        pStats->baLabelNames.append('\0');
+    }
+
+    pStats->mapLabels.insert(nAddress, label);
+}
+
+QString XDisasm::getDataString(XDisasm::STATS *pStats, XDisasm::VIEW_BLOCK *pViewBlock, QByteArray *pbaData) {
+    QString sResult;
+
+    QString sText;
+    QString sDirective;
+
+    if (pViewBlock->dataType == DT_ANSISTRING) {
+        sText = QString::fromLatin1(pbaData->constData(), qMax(pbaData->size() - 1, 0));
+        sDirective = "db";
+    } else if (pViewBlock->dataType == DT_UNICODESTRING) {
+        sText = QString::fromUtf16((const ushort *)(pbaData->constData()), qMax(pbaData->size() / 2 - 1, 0));
+        sDirective = "du";
+    }
+
+    if (pViewBlock->dataType == DT_REPEAT) {
+        if (pbaData->size()) {
+            sResult = QString("db 0x%1 dup(0x%2)").arg(pViewBlock->nSize, 0, 16).arg((quint8)(pbaData->at(0)), 2, 16, QChar('0'));
+        }
+    } else if (pViewBlock->dataType >= DT_POINTER32) {
+        qint32 nItemSize = 4;
+
+        if ((pViewBlock->dataType == DT_POINTER64) || (pViewBlock->dataType == DT_QWORDARRAY)) {
+            nItemSize = 8;
+        }
+
+        qint64 nNumberOfItems = pViewBlock->nSize / nItemSize;
+        qint64 nNumberOfShown = qMin(qMin(nNumberOfItems, (qint64)N_DATA_MAXITEMS), (qint64)(pbaData->size() / nItemSize));
+
+        QStringList listItems;
+
+        for (qint64 i = 0; i < nNumberOfShown; i++) {
+            const uchar *pItem = (const uchar *)(pbaData->constData() + i * nItemSize);
+
+            qint64 nValue = (nItemSize == 8) ? qFromLittleEndian<qint64>(pItem) : qFromLittleEndian<quint32>(pItem);
+
+            QString sLabel;
+
+            if ((pViewBlock->dataType == DT_POINTER32) || (pViewBlock->dataType == DT_POINTER64)) {
+                sLabel = getLabelString(pStats, nValue);
+            }
+
+            if (sLabel != "") {
+                listItems.append(QString("offset %1").arg(sLabel));
+            } else {
+                listItems.append(QString("0x%1").arg(nValue, 0, 16));
+            }
+        }
+
+        if (nNumberOfShown < nNumberOfItems) {
+            listItems.append(QString("... (%1)").arg(nNumberOfItems));
+        }
+
+        sResult = QString("%1 %2").arg((nItemSize == 8) ? "dq" : "dd", listItems.join(", "));
+    } else if (sDirective != "") {
+        sText.replace("\\", "\\\\");
+        sText.replace("\"", "\\\"");
+        sText.replace("\t", "\\t");
+        sText.replace("\n", "\\n");
+        sText.replace("\r", "\\r");
+
+        sResult = QString("%1 \"%2\", 0").arg(sDirective, sText);
+    }
+
+    return sResult;
+}
+
+QList<XDisasm::XREF> XDisasm::getXrefsTo(XDisasm::STATS *pStats, qint64 nAddress) {
+    return _getXrefs(&(pStats->xrefsTo), nAddress, true);
+}
+
+QList<XDisasm::XREF> XDisasm::getXrefsFrom(XDisasm::STATS *pStats, qint64 nAddress) {
+    return _getXrefs(&(pStats->xrefsFrom), nAddress, false);
+}
+
+QList<qint64> XDisasm::getOpcodeAddresses(XDisasm::STATS *pStats, quint32 nOpcodeID) {
+    return _getPostings(&(pStats->opcodeIndex), nOpcodeID);
+}
+
+QList<qint64> XDisasm::getValueAddresses(XDisasm::STATS *pStats, quint64 nValue) {
+    return _getPostings(&(pStats->valueIndex), nValue);
+}
+
+bool XDisasm::getQueryKeys(QIODevice *pDevice, XDisasm::STATS *pStats, qint64 nAddress, quint32 *pnOpcodeID, QList<quint64> *pListValues, QString *psMnemonic) {
+    bool bResult = false;
+
+    qint64 nOffset = XBinary::addressToOffset(&(pStats->memoryMap), nAddress);
+
+    if (nOffset != -1) {
+        char opcode[N_X64_OPCODE_SIZE];
+
+        qint64 nDataSize = XBinary::read_array(pDevice, nOffset, opcode, N_X64_OPCODE_SIZE);
+
+        csh disasm_handle = 0;
+
+        // The same detail level as the traversal, so the keys are the indexed ones
+        if ((nDataSize > 0) && XDisasmArch::openHandle(pStats->csarch, pStats->csmode, XDisasmArch::DP_TRAVERSE, &disasm_handle)) {
+            cs_insn *pInsn = cs_malloc(disasm_handle);
+
+            const uint8_t *pData = (const uint8_t *)opcode;
+            size_t _nDataSize = nDataSize;
+            uint64_t _nAddress = nAddress;
+
+            if (cs_disasm_iter(disasm_handle, &pData, &_nDataSize, &_nAddress, pInsn)) {
+                quint64 nValues[N_QUERY_MAXVALUES];
+                qint32 nNumberOfValues = XDisasmArch::getOperandValues(pStats->csarch, pStats->csmode, pInsn, nValues, N_QUERY_MAXVALUES);
 
-    if (nNumberOfOpcodes > 0) {
-        QString sMnemonic = pInsn->mnemonic;
-        QString sArgs = pInsn->op_str;
+                *pnOpcodeID = pInsn->id;
+                *psMnemonic = pInsn->mnemonic;
 
-        sResult = sMnemonic;
-        if (sArgs != "") {
-            sResult += " " + sArgs;
+                for (qint32 i = 0; i < nNumberOfValues; i++) {
+                    pListValues->append(nValues[i]);
+                }
+
+                bResult = true;
+            }
+
+            cs_free(pInsn, 1);
+            cs_close(&disasm_handle);
         }
+    }
+
+    return bResult;
+}
 
-        cs_free(pInsn, nNumberOfOpcodes);
+QString XDisasm::xrefTypeToString(XDisasm::XREF_TYPE type) {
+    QString sResult;
+
+    switch (type) {
+        case XREF_TYPE_CALL:
+            sResult = tr("Call");
+            break;
+        case XREF_TYPE_JUMP:
+            sResult = tr("Jump");
+            break;
+        case XREF_TYPE_DATA:
+            sResult = tr("Data");
+            break;
+        default:
+            sResult = tr("Unknown");
     }
 
     return sResult;
@@ -583,31 +2946,67 @@ QString XDisasm::getDisasmString(csh disasm_handle, qint64 nAddress, char *pData
 QList<XDisasm::SIGNATURE_RECORD> XDisasm::getSignature(XDisasm::SIGNATURE_OPTIONS *pSignatureOptions, qint64 nAddress) {
     QList<SIGNATURE_RECORD> listResult;
 
-    csh _disasm_handle;
-    cs_err err = cs_open(pSignatureOptions->csarch, pSignatureOptions->csmode, &_disasm_handle);
-    if (!err) {
-        cs_option(_disasm_handle, CS_OPT_DETAIL, CS_OPT_ON);
+    csh _disasm_handle = 0;
+
+    if (XDisasmArch::openHandle(pSignatureOptions->csarch, pSignatureOptions->csmode, XDisasmArch::DP_FULL, &_disasm_handle)) {
+        XDisasmArch::FLOW_TABLE flowTable = {};
+        XDisasmArch::initFlowTable(&flowTable, pSignatureOptions->csarch);
+
+        cs_insn *pInsn = cs_malloc(_disasm_handle);
+
+        if (pInsn) {
+            appendSignature(pSignatureOptions, _disasm_handle, pInsn, &flowTable, &listResult, nAddress);
+
+            cs_free(pInsn, 1);
+        }
+
+        cs_close(&_disasm_handle);
     }
 
+    return listResult;
+}
+
+bool XDisasm::appendSignature(XDisasm::SIGNATURE_OPTIONS *pSignatureOptions, csh disasm_handle, cs_insn *pInsn, XDisasmArch::FLOW_TABLE *pFlowTable,
+                              QList<XDisasm::SIGNATURE_RECORD> *pListRecords, qint64 nAddress) {
     QSet<qint64> stRecords;
 
+    int nNumberOfRecords = pListRecords->count();
+
+    for (int i = 0; i < nNumberOfRecords; i++) {
+        stRecords.insert(pListRecords->at(i).nAddress);
+    }
+
+    if (nNumberOfRecords) {
+        nAddress = pListRecords->last().nNextAddress;
+    }
+
     bool bStopBranch = false;
 
-    for (int i = 0; (i < pSignatureOptions->nCount) && (!bStopBranch); i++) {
+    for (int i = nNumberOfRecords; (i < pSignatureOptions->nCount) && (!bStopBranch); i++) {
         qint64 nOffset = XBinary::addressToOffset(&(pSignatureOptions->memoryMap), nAddress);
+
         if (nOffset != -1) {
             char opcode[N_X64_OPCODE_SIZE];
 
             XBinary::_zeroMemory(opcode, N_X64_OPCODE_SIZE);
 
-            size_t nDataSize = XBinary::read_array(pSignatureOptions->pDevice, nOffset, opcode, N_X64_OPCODE_SIZE);
+            size_t nDataSize = N_X64_OPCODE_SIZE;
+
+            // The analysis already knows the size of traced opcodes
+            if (pSignatureOptions->pStats) {
+                QMap<qint64, RECORD>::const_iterator iter = pSignatureOptions->pStats->mapRecords.constFind(nAddress);
+
+                if ((iter != pSignatureOptions->pStats->mapRecords.constEnd()) && (iter.value().type == RECORD_TYPE_OPCODE)) {
+                    nDataSize = qMin((qint64)N_X64_OPCODE_SIZE, iter.value().nSize);
+                }
+            }
 
-            uint8_t *pData = (uint8_t *)opcode;
+            nDataSize = XBinary::read_array(pSignatureOptions->pDevice, nOffset, opcode, nDataSize);
 
-            cs_insn *pInsn = 0;
-            size_t count = cs_disasm(_disasm_handle, pData, nDataSize, nAddress, 1, &pInsn);
+            const uint8_t *pData = (const uint8_t *)opcode;
+            uint64_t _nAddress = nAddress;
 
-            if (count > 0) {
+            if (cs_disasm_iter(disasm_handle, &pData, &nDataSize, &_nAddress, pInsn)) {
                 if (pInsn->size > 1) {
                     bStopBranch = !XBinary::isAddressPhysical(&(pSignatureOptions->memoryMap), nAddress + pInsn->size - 1);
                 }
@@ -629,74 +3028,34 @@ QList<XDisasm::SIGNATURE_RECORD> XDisasm::getSignature(XDisasm::SIGNATURE_OPTION
 
                     record.baOpcode = QByteArray(opcode, pInsn->size);
 
-                    record.nDispOffset = pInsn->detail->x86.encoding.disp_offset;
-                    record.nDispSize = pInsn->detail->x86.encoding.disp_size;
-                    record.nImmOffset = pInsn->detail->x86.encoding.imm_offset;
-                    record.nImmSize = pInsn->detail->x86.encoding.imm_size;
+                    XDisasmArch::getEncoding(pSignatureOptions->csarch, pSignatureOptions->csmode, pInsn, &(record.nDispOffset), &(record.nDispSize),
+                                             &(record.nImmOffset), &(record.nImmSize));
 
                     stRecords.insert(nAddress);
 
                     nAddress += pInsn->size;
 
                     if (pSignatureOptions->sm == XDisasm::SM_RELATIVEADDRESS) {
-                        for (int i = 0; i < pInsn->detail->x86.op_count; i++) {
-                            if (pInsn->detail->x86.operands[i].type == X86_OP_IMM) {
-                                qint64 nImm = pInsn->detail->x86.operands[i].imm;
+                        qint64 nImm = 0;
 
-                                if (isJmpOpcode(pInsn->id)) {
-                                    nAddress = nImm;
-                                    record.bIsConst = true;
-                                }
-                            }
+                        if ((XDisasmArch::getFlow(pFlowTable, disasm_handle, pInsn) & (XDisasmArch::FLOW_JUMP | XDisasmArch::FLOW_CALL)) &&
+                            XDisasmArch::getBranchAddress(pSignatureOptions->csarch, pSignatureOptions->csmode, pInsn, &nImm)) {
+                            nAddress = nImm;
+                            record.bIsConst = true;
                         }
                     }
 
-                    listResult.append(record);
-                }
+                    record.nNextAddress = nAddress;
 
-                cs_free(pInsn, count);
+                    pListRecords->append(record);
+                }
             } else {
                 bStopBranch = true;
             }
+        } else {
+            bStopBranch = true;
         }
     }
 
-    cs_close(&_disasm_handle);
-
-    return listResult;
-}
-
-bool XDisasm::isEndBranchOpcode(uint nOpcodeID) {
-    bool bResult = false;
-
-    // TODO more checks
-    if ((nOpcodeID == X86_INS_JMP) || (nOpcodeID == X86_INS_RET) || (nOpcodeID == X86_INS_INT3)) {
-        bResult = true;
-    }
-
-    return bResult;
-}
-
-bool XDisasm::isJmpOpcode(uint nOpcodeID) {
-    bool bResult = false;
-
-    if ((nOpcodeID == X86_INS_JMP) || (nOpcodeID == X86_INS_JA) || (nOpcodeID == X86_INS_JAE) || (nOpcodeID == X86_INS_JB) || (nOpcodeID == X86_INS_JBE) ||
-        (nOpcodeID == X86_INS_JCXZ) || (nOpcodeID == X86_INS_JE) || (nOpcodeID == X86_INS_JECXZ) || (nOpcodeID == X86_INS_JG) || (nOpcodeID == X86_INS_JGE) ||
-        (nOpcodeID == X86_INS_JL) || (nOpcodeID == X86_INS_JLE) || (nOpcodeID == X86_INS_JNE) || (nOpcodeID == X86_INS_JNO) || (nOpcodeID == X86_INS_JNP) ||
-        (nOpcodeID == X86_INS_JNS) || (nOpcodeID == X86_INS_JO) || (nOpcodeID == X86_INS_JP) || (nOpcodeID == X86_INS_JRCXZ) || (nOpcodeID == X86_INS_JS) ||
-        (nOpcodeID == X86_INS_LOOP) || (nOpcodeID == X86_INS_LOOPE) || (nOpcodeID == X86_INS_LOOPNE) || (nOpcodeID == X86_INS_CALL)) {
-        bResult = true;
-    }
-
-    return bResult;
-}
-
-bool XDisasm::isCallOpcode(uint nOpcodeID) {
-    bool bResult = false;
-
-    if (nOpcodeID == X86_INS_CALL) {
-        bResult = true;
-    }
-
-    return bResult;
+    return !bStopBranch;
 }
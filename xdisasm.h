@@ -21,7 +21,16 @@
 #ifndef XDISASM_H
 #define XDISASM_H
 
+#include <QBitArray>
+#include <QRegularExpression>
+#include <QThread>
+#include <QtConcurrent>
+#include <QtEndian>
+
 #include "capstone/capstone.h"
+#include "xdisasmarch.h"
+#include "xdisasmfingerprints.h"
+#include "xdisasmsignatureindex.h"
 #include "xformats.h"
 
 class XDisasm : public QObject {
@@ -29,12 +38,44 @@ class XDisasm : public QObject {
 
     static const int N_X64_OPCODE_SIZE = 15;
     static const int N_OPCODE_COUNT = 100000;
+    static const int N_LINEARSWEEP_CHUNKSIZE = 0x10000;
+    static const int N_LINEARSWEEP_OVERLAP = 0x100;
+    static const int N_LINEARSWEEP_COUNT = 0x400000;
+    static const int N_READBUFFER_SIZE = 0x1000;
+    static const int N_FINGERPRINT_MAXSIZE = 0x10000;
+    static const int N_FINGERPRINT_PATTERNSIZE = 32;
+    static const int N_STRING_MINSIZE = 5;
+    static const int N_STRING_CHUNKSIZE = 0x10000;
+    static const int N_DATA_CHUNKSIZE = 0x10000;
+    static const int N_DATA_REPEATSIZE = 16;
+    static const int N_DATA_ARRAYSIZE = 32;
+    static const int N_DATA_MAXITEMS = 8;
+    static const int N_POINTER_CHECKCOUNT = 4;
+    static const int N_POINTER_BLOCKSIZE = 16;  // slots per range test, one bit each
+    static const int N_GAP_OVERLAP = 0x1000;
+    static const int N_GAP_MININSTRUCTIONS = 3;
+    static const int N_GAP_MINPLAININSTRUCTIONS = 8;
+    static const int N_GAP_MAXINSTRUCTIONS = 0x400;
+    static const int N_SEARCH_CHUNKSIZE = 0x10000;
+    static const int N_SEARCH_OVERLAP = 0x100;
+    static const int N_QUERY_MAXVALUES = 2;
+    static const int N_LISTING_CHUNKROWS = 0x1000;
+    static const int N_LISTING_CHUNKSIZE = 0x100000;
+    static const int N_LISTING_ROWSIZE = 0x100;
+    static const int N_LISTING_BATCHSIZE = 4;  // chunks per thread kept in memory
 
 public:
     enum DM {
         DM_UNKNOWN = 0,
         DM_DISASM,
-        DM_TODATA
+        DM_TODATA,
+        DM_LINEARSWEEP,
+        DM_EXPORTFINGERPRINTS,
+        DM_RECOGNIZEFUNCTIONS,
+        DM_GAPANALYSIS,
+        DM_EXPORTLISTING,
+        DM_EXPORTCOLUMNS,
+        DM_STREAM
     };
 
     enum VBT {
@@ -50,20 +91,62 @@ public:
         RECORD_TYPE_DATA,
     };
 
+    enum DT {
+        DT_UNKNOWN = 0,
+        DT_ANSISTRING,
+        DT_UNICODESTRING,
+        DT_REPEAT,  // padding and fill, one byte value
+        DT_POINTER32,
+        DT_POINTER64,
+        DT_DWORDARRAY,
+        DT_QWORDARRAY
+    };
+
     struct RECORD {
         qint64 nOffset;
         qint64 nSize;
         RECORD_TYPE type;
+        DT dataType;
     };
 
-    //    enum LABEL_TYPE
-    //    {
-    //        LABEL_TYPE_UNKNOWN=0;
-    //        LABEL_TYPE_
-    //    };
+    enum LABEL_TYPE {
+        LABEL_TYPE_UNKNOWN = 0,
+        LABEL_TYPE_ENTRYPOINT,
+        LABEL_TYPE_FUNCTION,
+        LABEL_TYPE_JUMP,
+        LABEL_TYPE_LIBRARY,
+        LABEL_TYPE_STRING
+    };
 
     struct LABEL {
-        qint64 nName;
+        LABEL_TYPE type;
+        qint32 nName;  // offset in baLabelNames, -1 if the name is made from type and address
+    };
+
+    enum XREF_TYPE {
+        XREF_TYPE_UNKNOWN = 0,
+        XREF_TYPE_CALL,
+        XREF_TYPE_JUMP,
+        XREF_TYPE_DATA
+    };
+
+    struct XREF {
+        qint64 nFrom;
+        qint64 nTo;
+        XREF_TYPE type;
+    };
+
+    struct XREF_INDEX {
+        QVector<qint64> listKeys;     // sorted unique addresses
+        QVector<qint32> listOffsets;  // listKeys.count()+1 entries into listAddresses
+        QVector<qint64> listAddresses;
+        QVector<quint8> listTypes;
+    };
+
+    struct QUERY_INDEX {
+        QVector<quint64> listKeys;    // sorted unique instruction ids or operand values
+        QVector<qint32> listOffsets;  // listKeys.count()+1 entries into listAddresses
+        QVector<qint64> listAddresses;
     };
 
     struct VIEW_BLOCK {
@@ -71,6 +154,7 @@ public:
         qint64 nOffset;
         qint64 nSize;
         VBT type;
+        DT dataType;
     };
 
     struct STATS {
@@ -82,35 +166,77 @@ public:
         qint64 nImageSize;
         qint64 nEntryPointAddress;
         QMap<qint64, RECORD> mapRecords;
-        QMultiMap<qint64, qint64> mmapRefTo;
-        QMultiMap<qint64, qint64> mmapRefFrom;
+        qint32 nNumberOfOpcodes;  // strings in mapRecords do not count toward N_OPCODE_COUNT
+        QVector<XREF> listXrefs;  // found since the last _adjust, which moves them into the indexes
+        XREF_INDEX xrefsTo;
+        XREF_INDEX xrefsFrom;
+        QUERY_INDEX opcodeIndex;  // capstone instruction id
+        QUERY_INDEX valueIndex;   // immediates and absolute displacements
         QSet<qint64> stCalls;
         QSet<qint64> stJumps;
         QMultiMap<qint64, qint64> mmapDataLabels;  // TODO Check
         QMap<qint64, VIEW_BLOCK> mapVB;
-        QMap<qint64, QString> mapLabelStrings;
+        QList<qint64> listRelocs;  // addresses of relocated pointers, PE only
+        QMap<qint64, LABEL> mapLabels;
+        QByteArray baLabelNames;  // zero-terminated UTF-8 names
         qint64 nPositions;
         QMap<qint64, qint64> mapPositions;
         QMap<qint64, qint64> mapAddresses;
         bool bIsOverlayPresent;
         qint64 nOverlayOffset;
         qint64 nOverlaySize;
+        XDisasmSignatureIndex signatureIndex;  // n-grams of the code regions, built by the process
+        QList<qint64> listSignatureRegions;    // addresses of the indexed regions
     };
 
     struct OPTIONS {
         bool bIsImage;
         qint64 nImageBase;
         XBinary::FT fileType;
+        QString sFingerprintDatabase;
+        bool bSkipLibraryFunctions;
         XDisasm::STATS stats;
     };
 
+    struct FINGERPRINT {
+        qint64 nAddress;
+        cs_arch csarch;
+        cs_mode csmode;
+        QByteArray baData;
+        QByteArray baMask;  // 0xFF - byte is used, 0 - operand wildcard
+        QVector<qint32> listSizes;  // instruction sizes from STATS
+        quint64 nHash;
+    };
+
+    // DM_STREAM reports what the traversal finds instead of keeping it in STATS
+    class CONSUMER {
+    public:
+        virtual ~CONSUMER() {}
+        virtual void instruction(qint64 nAddress, qint32 nSize, quint32 nOpcodeID, const char *pData) = 0;
+        virtual void edge(qint64 nFrom, qint64 nTo, XREF_TYPE type) = 0;
+        virtual void label(qint64 nAddress, LABEL_TYPE type) = 0;
+    };
+
     explicit XDisasm(QObject *pParent = nullptr);
     ~XDisasm();
-    void setData(QIODevice *pDevice, OPTIONS *pOptions, qint64 nStartAddress, DM dm);
+    void setData(QIODevice *pDevice, OPTIONS *pOptions, qint64 nStartAddress, DM dm, QString sFileName = "");
     void stop();
+    void setConsumer(CONSUMER *pConsumer);
     STATS *getStats();
     static qint64 getVBSize(QMap<qint64, VIEW_BLOCK> *pMapVB);
     static QString getDisasmString(csh disasm_handle, qint64 nAddress, char *pData, qint32 nDataSize);
+    static QString getDisasmString(csh disasm_handle, cs_insn *pInsn, qint64 nAddress, char *pData, qint32 nDataSize);
+    static QString getOpcodeString(STATS *pStats, csh disasm_handle, cs_insn *pInsn, qint64 nAddress, char *pData, qint32 nDataSize, bool bShowLabels);
+    static QString getLabelString(STATS *pStats, qint64 nAddress);
+    static QString getLabelString(STATS *pStats, qint64 nAddress, LABEL label);
+    static void addLabel(STATS *pStats, qint64 nAddress, LABEL_TYPE type, QString sName = "");
+    static QString getDataString(STATS *pStats, VIEW_BLOCK *pViewBlock, QByteArray *pbaData);
+    static QList<XREF> getXrefsTo(STATS *pStats, qint64 nAddress);
+    static QList<XREF> getXrefsFrom(STATS *pStats, qint64 nAddress);
+    static QString xrefTypeToString(XREF_TYPE type);
+    static QList<qint64> getOpcodeAddresses(STATS *pStats, quint32 nOpcodeID);
+    static QList<qint64> getValueAddresses(STATS *pStats, quint64 nValue);
+    static bool getQueryKeys(QIODevice *pDevice, STATS *pStats, qint64 nAddress, quint32 *pnOpcodeID, QList<quint64> *pListValues, QString *psMnemonic);
 
     enum SM {
         SM_NORMAL = 0,
@@ -124,6 +250,7 @@ public:
         cs_mode csmode;
         int nCount;
         SM sm;
+        STATS *pStats;  // optional, sizes of traced opcodes
     };
 
     struct SIGNATURE_RECORD {
@@ -135,23 +262,150 @@ public:
         qint32 nImmOffset;
         qint32 nImmSize;
         bool bIsConst;
+        qint64 nNextAddress;
     };
 
     static QList<SIGNATURE_RECORD> getSignature(SIGNATURE_OPTIONS *pSignatureOptions, qint64 nAddress);
+    static bool appendSignature(SIGNATURE_OPTIONS *pSignatureOptions, csh disasm_handle, cs_insn *pInsn, XDisasmArch::FLOW_TABLE *pFlowTable,
+                                QList<SIGNATURE_RECORD> *pListRecords, qint64 nAddress);
+    static QList<XBinary::_MEMORY_RECORD> getCodeRegions(STATS *pStats);
+    static QList<FINGERPRINT> getFingerprints(QIODevice *pDevice, STATS *pStats, QList<qint64> *pListAddresses, bool *pbStop = nullptr);
+    static QString getFingerprintPattern(const FINGERPRINT *pFingerprint);
+
+    struct SEARCH_CHUNK {
+        STATS *pStats;  // read only while the search runs
+        QRegularExpression regExp;
+        bool bShowLabels;
+        qint64 nAddress;
+        qint64 nOffset;
+        qint64 nSize;
+        QString sFileName;  // each worker opens its own file, the device is not shared
+        QByteArray baData;  // read by the caller if the device is not a file
+        bool *pbStop;
+    };
+
+    struct SEARCH_RESULT {
+        qint64 nAddress;
+        QString sText;
+    };
+
+    static QList<SEARCH_CHUNK> getSearchChunks(QIODevice *pDevice, STATS *pStats, QRegularExpression regExp, bool bShowLabels, bool *pbStop);
+    static QList<SEARCH_RESULT> searchChunk(const SEARCH_CHUNK &chunk);
 
 public slots:
     void processDisasm();
     void processToData();
+    void processLinearSweep();
+    void processExportFingerprints();
+    void processRecognizeFunctions();
+    void processGapAnalysis();
+    void processExportListing();
+    void processExportColumns();
+    void processStream();
     void process();
 
 private:
-    bool isEndBranchOpcode(uint nOpcodeID);
-    static bool isJmpOpcode(uint nOpcodeID);
-    static bool isCallOpcode(uint nOpcodeID);
-    void _disasm(qint64 nInitAddress, qint64 nAddress);
+    struct SWEEP_RECORD {
+        qint64 nAddress;
+        qint32 nSize;
+        bool bIsCall;
+        qint64 nBranchAddress;
+        qint64 nDataAddress;
+        quint32 nOpcodeID;
+        qint32 nNumberOfValues;
+        quint64 nValues[N_QUERY_MAXVALUES];
+    };
+
+    struct QUERY_ENTRY {
+        quint64 nKey;
+        qint64 nAddress;
+    };
+
+    struct SWEEP_CHUNK {
+        qint64 nAddress;
+        qint64 nSize;
+        QByteArray baData;  // nSize bytes + overlap for resync
+        cs_arch csarch;
+        cs_mode csmode;
+        bool *pbStop;
+        QVector<SWEEP_RECORD> listRecords;
+    };
+
+    struct GAP_CANDIDATE {
+        qint64 nAddress;
+        bool bIsPrologue;
+        bool bIsValid;
+        qint32 nNumberOfInstructions;
+    };
+
+    struct GAP_CHUNK {
+        qint64 nAddress;
+        qint64 nSize;  // candidates are taken from this part
+        bool bIsGapStart;  // false for the following chunks of a long gap
+        qint64 nRegionAddress;
+        qint64 nRegionSize;
+        QByteArray baData;  // up to the gap end, at most nSize + overlap
+        cs_arch csarch;
+        cs_mode csmode;
+        bool *pbStop;
+        const QMap<qint64, RECORD> *pMapRecords;  // read only while workers run
+        QVector<GAP_CANDIDATE> listCandidates;
+    };
+
+    struct LISTING_CHUNK {
+        qint64 nAddress;
+        qint64 nEndAddress;
+        qint64 nOffset;  // -1 if the rows have no file data
+        QByteArray baData;
+        STATS *pStats;  // read only while workers run
+        bool *pbStop;
+        QByteArray baText;
+    };
+
+    bool _initStats();
+    void _analyze(bool bIsInit);
+    void _loadStats();
+    bool _openHandle();
+    void _closeHandle();
+    const char *_readData(qint64 nOffset, qint64 *pnDataSize);
+    void _disasm(qint64 nAddress);
+    void _stream(qint64 nAddress);
+    bool _testAndSet(QBitArray *pBitArray, qint64 nAddress);
+    void _linearSweep();
+    static void _sweepChunk(SWEEP_CHUNK &chunk);
+    static bool _isSweepBoundary(const QVector<SWEEP_RECORD> *pListRecords, qint64 nAddress);
+    bool _insertSweepRecord(const SWEEP_RECORD *pRecord, qint64 nOffset);
+    static void _fingerprint(FINGERPRINT &fingerprint);
+    void _loadFingerprints();
+    bool _isLibraryFunction(qint64 nAddress);
+    void _recognizeFunctions();
+    static quint64 _getZeroMask(quint64 nValue);
+    static quint64 _getPrintableMask(quint64 nValue);
+    void _findStrings();
+    void _insertString(qint64 nAddress, qint64 nOffset, qint64 nSize, DT dataType);
+    void _removeDataRecords(qint64 nAddress, qint64 nSize);
+    static qint64 _getRepeatSize(const char *pData, qint64 nSize);
+    void _addDataBlocks(qint64 nAddress, qint64 nOffset, qint64 nSize);
+    static bool _isInRegions(const QList<XBinary::_MEMORY_RECORD> *pListRegions, qint64 nAddress);
+    bool _isCodePointer(qint64 nAddress);
+    static quint32 _getPointerHits(const char *pData, qint32 nPointerSize, quint64 nMinAddress, quint64 nRange);
+    void _discoverPointers();
+    static bool _isPrologue(const char *pData, qint64 nSize, cs_mode csmode);
+    static void _gapChunk(GAP_CHUNK &chunk);
+    void _gapAnalysis();
+    static void _listingChunk(LISTING_CHUNK &chunk);
+    bool _exportListing(QIODevice *pDevice);
+    void _addXref(qint64 nFrom, qint64 nTo, XREF_TYPE type);
+    static void _buildXrefIndex(QVector<XREF> *pListXrefs, XREF_INDEX *pIndex, bool bIsTo);
+    void _takeXrefIndex();
+    static QList<XREF> _getXrefs(const XREF_INDEX *pIndex, qint64 nAddress, bool bIsTo);
+    void _addQueryEntries(qint64 nAddress, quint32 nOpcodeID, const quint64 *pValues, qint32 nNumberOfValues);
+    void _buildQueryIndex(QVector<QUERY_ENTRY> *pListEntries, QUERY_INDEX *pIndex);
+    static QList<qint64> _getPostings(const QUERY_INDEX *pIndex, quint64 nKey);
     void _adjust();
     void _updatePositions();
-    bool _insertOpcode(qint64 nAddress, RECORD *pOpcode);
+    void _updateSignatureIndex();
+    bool _insertOpcode(qint64 nAddress, RECORD *pOpcode, qint32 nMaxCount = N_OPCODE_COUNT);
 
 signals:
     void errorMessage(QString sText);
@@ -160,10 +414,23 @@ signals:
 private:
     DM g_dm;
     csh g_disasm_handle;
+    cs_insn *g_pInsn;
+    XDisasmArch::FLOW_TABLE g_flowTable;
+    QVector<QUERY_ENTRY> g_listOpcodeEntries;  // found since the last _adjust
+    QVector<QUERY_ENTRY> g_listValueEntries;
+    CONSUMER *g_pConsumer;
+    QBitArray g_baVisited;  // instruction starts, DM_STREAM only
+    QBitArray g_baLabels;
+    QByteArray g_baReadBuffer;
+    qint64 g_nReadBufferOffset;
+    qint64 g_nReadBufferSize;
     bool g_bStop;
     QIODevice *g_pDevice;
     OPTIONS *g_pOptions;
     qint64 g_nStartAddress;
+    QString g_sFileName;
+    XDisasmFingerprints g_fingerprints;
+    QHash<qint64, bool> g_mapLibraryFunctions;  // by call target, misses included
 };
 
 #endif  // XDISASM_H
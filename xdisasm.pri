@@ -1,3 +1,5 @@
+QT += concurrent
+
 INCLUDEPATH += $$PWD
 DEPENDPATH += $$PWD
 
@@ -5,24 +7,46 @@ SOURCES += \
     $$PWD/dialogdisasm.cpp \
     $$PWD/dialogdisasmlabels.cpp \
     $$PWD/dialogdisasmprocess.cpp \
+    $$PWD/dialogdisasmresults.cpp \
+    $$PWD/dialogdisasmsearch.cpp \
     $$PWD/dialogasmsignature.cpp \
     $$PWD/xdisasm.cpp \
+    $$PWD/xdisasmarch.cpp \
+    $$PWD/xdisasmcolumns.cpp \
+    $$PWD/xdisasmfingerprints.cpp \
+    $$PWD/xdisasmlabelsmodel.cpp \
     $$PWD/xdisasmmodel.cpp \
+    $$PWD/xdisasmsignature.cpp \
+    $$PWD/xdisasmsignatureindex.cpp \
+    $$PWD/xdisasmsignaturemodel.cpp \
+    $$PWD/xdisasmview.cpp \
     $$PWD/xdisasmwidget.cpp
 
 HEADERS += \
     $$PWD/dialogdisasm.h \
     $$PWD/dialogdisasmlabels.h \
     $$PWD/dialogdisasmprocess.h \
+    $$PWD/dialogdisasmresults.h \
+    $$PWD/dialogdisasmsearch.h \
     $$PWD/dialogasmsignature.h \
     $$PWD/xdisasm.h \
+    $$PWD/xdisasmarch.h \
+    $$PWD/xdisasmcolumns.h \
+    $$PWD/xdisasmfingerprints.h \
+    $$PWD/xdisasmlabelsmodel.h \
     $$PWD/xdisasmmodel.h \
+    $$PWD/xdisasmsignature.h \
+    $$PWD/xdisasmsignatureindex.h \
+    $$PWD/xdisasmsignaturemodel.h \
+    $$PWD/xdisasmview.h \
     $$PWD/xdisasmwidget.h
 
 FORMS += \
     $$PWD/dialogdisasm.ui \
     $$PWD/dialogdisasmlabels.ui \
     $$PWD/dialogdisasmprocess.ui \
+    $$PWD/dialogdisasmresults.ui \
+    $$PWD/dialogdisasmsearch.ui \
     $$PWD/dialogasmsignature.ui \
     $$PWD/xdisasmwidget.ui
 
@@ -0,0 +1,665 @@
+// Copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "xdisasmarch.h"
+
+static const unsigned int _X86_JUMPS[] = {X86_INS_JMP,  X86_INS_LJMP,  X86_INS_JA,     X86_INS_JAE, X86_INS_JB,    X86_INS_JBE,  X86_INS_JCXZ,
+                                          X86_INS_JE,   X86_INS_JECXZ, X86_INS_JG,     X86_INS_JGE, X86_INS_JL,    X86_INS_JLE,  X86_INS_JNE,
+                                          X86_INS_JNO,  X86_INS_JNP,   X86_INS_JNS,    X86_INS_JO,  X86_INS_JP,    X86_INS_JRCXZ, X86_INS_JS,
+                                          X86_INS_LOOP, X86_INS_LOOPE, X86_INS_LOOPNE};
+static const unsigned int _X86_CALLS[] = {X86_INS_CALL, X86_INS_LCALL};
+static const unsigned int _X86_ENDBRANCHES[] = {X86_INS_JMP,   X86_INS_LJMP,  X86_INS_RET,  X86_INS_RETF, X86_INS_RETFQ,  X86_INS_IRET,   X86_INS_IRETD,
+                                                X86_INS_IRETQ, X86_INS_INT3,  X86_INS_HLT,  X86_INS_UD2,  X86_INS_SYSRET, X86_INS_SYSEXIT};
+
+static const unsigned int _ARM_JUMPS[] = {ARM_INS_B, ARM_INS_BX, ARM_INS_CBZ, ARM_INS_CBNZ};
+static const unsigned int _ARM_CALLS[] = {ARM_INS_BL, ARM_INS_BLX};
+static const unsigned int _ARM_ENDBRANCHES[] = {ARM_INS_B, ARM_INS_BX};
+
+static const unsigned int _ARM64_JUMPS[] = {ARM64_INS_B, ARM64_INS_BR, ARM64_INS_CBZ, ARM64_INS_CBNZ, ARM64_INS_TBZ, ARM64_INS_TBNZ};
+static const unsigned int _ARM64_CALLS[] = {ARM64_INS_BL, ARM64_INS_BLR};
+static const unsigned int _ARM64_ENDBRANCHES[] = {ARM64_INS_B, ARM64_INS_BR, ARM64_INS_RET};
+
+static const unsigned int _MIPS_JUMPS[] = {MIPS_INS_J,    MIPS_INS_JR,   MIPS_INS_B,    MIPS_INS_BEQ,  MIPS_INS_BNE,  MIPS_INS_BEQZ,
+                                           MIPS_INS_BNEZ, MIPS_INS_BGEZ, MIPS_INS_BGTZ, MIPS_INS_BLEZ, MIPS_INS_BLTZ};
+static const unsigned int _MIPS_CALLS[] = {MIPS_INS_JAL, MIPS_INS_JALR, MIPS_INS_BAL, MIPS_INS_BGEZAL, MIPS_INS_BLTZAL};
+static const unsigned int _MIPS_ENDBRANCHES[] = {MIPS_INS_J, MIPS_INS_JR, MIPS_INS_B};
+
+static const unsigned int _PPC_JUMPS[] = {PPC_INS_B, PPC_INS_BA, PPC_INS_BC, PPC_INS_BLR, PPC_INS_BCTR};
+static const unsigned int _PPC_CALLS[] = {PPC_INS_BL, PPC_INS_BLA, PPC_INS_BCL, PPC_INS_BCTRL};
+static const unsigned int _PPC_ENDBRANCHES[] = {PPC_INS_B, PPC_INS_BA, PPC_INS_BLR, PPC_INS_BCTR};
+
+// ModRM presence, one bit per opcode, rows by high nibble
+static const quint16 _X86_MODRM[16] = {0x0F0F, 0x0F0F, 0x0F0F, 0x0F0F, 0x0000, 0x0000, 0x0A0C, 0x0000,
+                                       0xFFFF, 0x0000, 0x0000, 0x0000, 0x00F3, 0xFF0F, 0x0000, 0xC0C0};
+static const quint16 _X86_MODRM_0F[16] = {0xA00F, 0xFFFF, 0xFFFF, 0x0000, 0xFFFF, 0xFFFF, 0xFFFF, 0xFF7F,
+                                          0x0000, 0xFFFF, 0xF838, 0xFFFF, 0x00FF, 0xFFFF, 0xFFFF, 0xFFFF};
+
+#define _ARCH_LIST(x) x, (qint32)(sizeof(x) / sizeof(x[0]))
+
+static const XDisasmArch::ARCH_RECORD _ARCH_RECORDS[] = {
+    {CS_ARCH_X86, X86_INS_ENDING, _ARCH_LIST(_X86_JUMPS), _ARCH_LIST(_X86_CALLS), _ARCH_LIST(_X86_ENDBRANCHES), 0, false},
+    {CS_ARCH_ARM, ARM_INS_ENDING, _ARCH_LIST(_ARM_JUMPS), _ARCH_LIST(_ARM_CALLS), _ARCH_LIST(_ARM_ENDBRANCHES), 0, true},
+    {CS_ARCH_ARM64, ARM64_INS_ENDING, _ARCH_LIST(_ARM64_JUMPS), _ARCH_LIST(_ARM64_CALLS), _ARCH_LIST(_ARM64_ENDBRANCHES), 0, true},
+    {CS_ARCH_MIPS, MIPS_INS_ENDING, _ARCH_LIST(_MIPS_JUMPS), _ARCH_LIST(_MIPS_CALLS), _ARCH_LIST(_MIPS_ENDBRANCHES), 1, false},
+    {CS_ARCH_PPC, PPC_INS_ENDING, _ARCH_LIST(_PPC_JUMPS), _ARCH_LIST(_PPC_CALLS), _ARCH_LIST(_PPC_ENDBRANCHES), 0, true},
+};
+
+bool XDisasmArch::getCsArchMode(XBinary::_MEMORY_MAP *pMemoryMap, cs_arch *pCsArch, cs_mode *pCsMode) {
+    bool bResult = true;
+
+    QString sArch = pMemoryMap->sArch.toUpper();
+    bool bIs64 = (pMemoryMap->mode == XBinary::MODE_64);
+    int nEndian = (pMemoryMap->endian == XBinary::ENDIAN_BIG) ? CS_MODE_BIG_ENDIAN : CS_MODE_LITTLE_ENDIAN;
+
+    if (XBinary::isX86asm(pMemoryMap->sArch)) {
+        *pCsArch = CS_ARCH_X86;
+
+        if ((pMemoryMap->mode == XBinary::MODE_16) || (pMemoryMap->mode == XBinary::MODE_16SEG)) {
+            *pCsMode = CS_MODE_16;
+        } else if (pMemoryMap->mode == XBinary::MODE_32) {
+            *pCsMode = CS_MODE_32;
+        } else if (pMemoryMap->mode == XBinary::MODE_64) {
+            *pCsMode = CS_MODE_64;
+        }
+    } else if ((sArch == "ARM64") || (sArch == "AARCH64")) {
+        *pCsArch = CS_ARCH_ARM64;
+        *pCsMode = (cs_mode)(CS_MODE_ARM | nEndian);
+    } else if ((sArch == "THUMB") || (sArch == "ARMNT")) {
+        *pCsArch = CS_ARCH_ARM;
+        *pCsMode = (cs_mode)(CS_MODE_THUMB | nEndian);
+    } else if (sArch.startsWith("ARM")) {
+        *pCsArch = CS_ARCH_ARM;
+        *pCsMode = (cs_mode)(CS_MODE_ARM | nEndian);
+    } else if (sArch.startsWith("MIPS")) {
+        *pCsArch = CS_ARCH_MIPS;
+        *pCsMode = (cs_mode)((bIs64 ? CS_MODE_MIPS64 : CS_MODE_MIPS32) | nEndian);
+    } else if (sArch.startsWith("PPC") || sArch.startsWith("POWERPC")) {
+        *pCsArch = CS_ARCH_PPC;
+        *pCsMode = (cs_mode)((bIs64 ? CS_MODE_64 : CS_MODE_32) | nEndian);
+    } else {
+        bResult = false;
+    }
+
+    return bResult;
+}
+
+bool XDisasmArch::openHandle(cs_arch csarch, cs_mode csmode, DP dp, csh *pHandle) {
+    bool bResult = false;
+
+    cs_err err = cs_open(csarch, csmode, pHandle);
+    if (!err) {
+        // x86 traversal reads flow and targets from the flow table and getX86Encoding, so it skips cs_detail
+        bool bDetail = (dp == DP_FULL) || ((dp == DP_TRAVERSE) && (csarch != CS_ARCH_X86));
+
+        if (bDetail) {
+            cs_option(*pHandle, CS_OPT_DETAIL, CS_OPT_ON);
+        }
+
+        bResult = true;
+    } else {
+        *pHandle = 0;
+    }
+
+    return bResult;
+}
+
+const XDisasmArch::ARCH_RECORD *XDisasmArch::getArchRecord(cs_arch csarch) {
+    const ARCH_RECORD *pResult = 0;
+
+    int nNumberOfRecords = sizeof(_ARCH_RECORDS) / sizeof(_ARCH_RECORDS[0]);
+
+    for (int i = 0; i < nNumberOfRecords; i++) {
+        if (_ARCH_RECORDS[i].csarch == csarch) {
+            pResult = &(_ARCH_RECORDS[i]);
+            break;
+        }
+    }
+
+    return pResult;
+}
+
+void XDisasmArch::initFlowTable(FLOW_TABLE *pFlowTable, cs_arch csarch) {
+    pFlowTable->csarch = csarch;
+    pFlowTable->bIsPredicated = false;
+    pFlowTable->listFlows.clear();
+
+    const ARCH_RECORD *pRecord = getArchRecord(csarch);
+
+    if (pRecord) {
+        pFlowTable->bIsPredicated = pRecord->bIsPredicated;
+        pFlowTable->listFlows.fill(0, pRecord->nNumberOfOpcodes);
+
+        _setFlow(pFlowTable, pRecord->pJumps, pRecord->nNumberOfJumps, FLOW_JUMP);
+        _setFlow(pFlowTable, pRecord->pCalls, pRecord->nNumberOfCalls, FLOW_CALL);
+        _setFlow(pFlowTable, pRecord->pEndBranches, pRecord->nNumberOfEndBranches, FLOW_END);
+    }
+}
+
+quint32 XDisasmArch::getFlow(FLOW_TABLE *pFlowTable, csh handle, cs_insn *pInsn) {
+    quint32 nResult = 0;
+
+    if (pInsn->id < (uint)pFlowTable->listFlows.size()) {
+        nResult = pFlowTable->listFlows.at(pInsn->id);
+
+        if (!(nResult & FLOW_KNOWN)) {
+            nResult = _classify(pFlowTable, handle, pInsn);
+        }
+
+        // pop {..., pc}, ldr pc, [...] and mov pc, lr share ids with plain loads and moves
+        if ((pFlowTable->csarch == CS_ARCH_ARM) && (!(nResult & (FLOW_JUMP | FLOW_CALL | FLOW_END))) && _isPCWritten(handle, pInsn)) {
+            nResult |= (FLOW_JUMP | FLOW_END | FLOW_PREDICATED);
+        }
+
+        if ((nResult & FLOW_PREDICATED) && (!_isUnconditional(pFlowTable->csarch, pInsn))) {
+            nResult &= ~((quint32)FLOW_END);
+        }
+    }
+
+    return nResult;
+}
+
+qint32 XDisasmArch::getDelaySlots(cs_arch csarch) {
+    qint32 nResult = 0;
+
+    const ARCH_RECORD *pRecord = getArchRecord(csarch);
+
+    if (pRecord) {
+        nResult = pRecord->nDelaySlots;
+    }
+
+    return nResult;
+}
+
+bool XDisasmArch::getBranchAddress(cs_arch csarch, cs_mode csmode, cs_insn *pInsn, qint64 *pnAddress) {
+    bool bResult = false;
+
+    // The target is the last immediate operand: cbz/tbz/beq carry a register or bit number first
+    if ((csarch == CS_ARCH_X86) && (pInsn->detail == 0)) {
+        X86_ENCODING encoding = {};
+
+        if (getX86Encoding(pInsn->bytes, pInsn->size, csmode, &encoding) && encoding.bIsRelative) {
+            qint64 nDelta = 0;
+
+            if (encoding.nImmSize == 1) {
+                nDelta = *((qint8 *)(pInsn->bytes + encoding.nImmOffset));
+            } else if (encoding.nImmSize == 2) {
+                nDelta = *((qint16 *)(pInsn->bytes + encoding.nImmOffset));
+            } else if (encoding.nImmSize == 4) {
+                nDelta = *((qint32 *)(pInsn->bytes + encoding.nImmOffset));
+            }
+
+            *pnAddress = pInsn->address + pInsn->size + nDelta;
+
+            if (encoding.bIsOperandSize16) {
+                *pnAddress &= 0xFFFF;
+            } else if (!(csmode & CS_MODE_64)) {
+                *pnAddress &= 0xFFFFFFFF;
+            }
+
+            bResult = true;
+        }
+    } else if (csarch == CS_ARCH_X86) {
+        for (int i = 0; i < pInsn->detail->x86.op_count; i++) {
+            if (pInsn->detail->x86.operands[i].type == X86_OP_IMM) {
+                *pnAddress = pInsn->detail->x86.operands[i].imm;
+                bResult = true;
+            }
+        }
+    } else if ((csarch == CS_ARCH_ARM) && (pInsn->id != ARM_INS_BLX)) {
+        // blx #imm switches between ARM and Thumb, its target is not decoded in the mode of the caller
+        for (int i = 0; i < pInsn->detail->arm.op_count; i++) {
+            if (pInsn->detail->arm.operands[i].type == ARM_OP_IMM) {
+                *pnAddress = (quint32)pInsn->detail->arm.operands[i].imm;
+                bResult = true;
+            }
+        }
+    } else if (csarch == CS_ARCH_ARM64) {
+        for (int i = 0; i < pInsn->detail->arm64.op_count; i++) {
+            if (pInsn->detail->arm64.operands[i].type == ARM64_OP_IMM) {
+                *pnAddress = pInsn->detail->arm64.operands[i].imm;
+                bResult = true;
+            }
+        }
+    } else if (csarch == CS_ARCH_MIPS) {
+        for (int i = 0; i < pInsn->detail->mips.op_count; i++) {
+            if (pInsn->detail->mips.operands[i].type == MIPS_OP_IMM) {
+                *pnAddress = pInsn->detail->mips.operands[i].imm;
+                bResult = true;
+            }
+        }
+    } else if (csarch == CS_ARCH_PPC) {
+        for (int i = 0; i < pInsn->detail->ppc.op_count; i++) {
+            if (pInsn->detail->ppc.operands[i].type == PPC_OP_IMM) {
+                *pnAddress = pInsn->detail->ppc.operands[i].imm;
+                bResult = true;
+            }
+        }
+    }
+
+    return bResult;
+}
+
+bool XDisasmArch::getDataAddress(cs_arch csarch, cs_mode csmode, cs_insn *pInsn, qint64 *pnAddress) {
+    bool bResult = false;
+
+    // Only a candidate: the caller checks that the address is in the memory map
+    if ((csarch == CS_ARCH_X86) && (pInsn->detail == 0)) {
+        X86_ENCODING encoding = {};
+
+        if (getX86Encoding(pInsn->bytes, pInsn->size, csmode, &encoding) && (!encoding.bIsRelative)) {
+            if (encoding.bIsRipRelative && (encoding.nDispSize == 4)) {
+                *pnAddress = pInsn->address + pInsn->size + *((qint32 *)(pInsn->bytes + encoding.nDispOffset));
+                bResult = true;
+            } else if (encoding.bIsAbsoluteDisp && (encoding.nDispSize == 8)) {
+                // moffs64
+                *pnAddress = *((qint64 *)(pInsn->bytes + encoding.nDispOffset));
+                bResult = true;
+            } else if (encoding.bIsAbsoluteDisp && (encoding.nDispSize == 4)) {
+                // 64-bit mode sign-extends the displacement of a SIB byte with no base and no index
+                if (csmode & CS_MODE_64) {
+                    *pnAddress = *((qint32 *)(pInsn->bytes + encoding.nDispOffset));
+                } else {
+                    *pnAddress = *((quint32 *)(pInsn->bytes + encoding.nDispOffset));
+                }
+
+                bResult = true;
+            } else if ((!(csmode & CS_MODE_64)) && (encoding.nImmSize == 4)) {
+                *pnAddress = *((quint32 *)(pInsn->bytes + encoding.nImmOffset));
+                bResult = true;
+            } else if ((csmode & CS_MODE_64) && (encoding.nImmSize == 8)) {
+                *pnAddress = *((qint64 *)(pInsn->bytes + encoding.nImmOffset));
+                bResult = true;
+            }
+        }
+    } else if (csarch == CS_ARCH_X86) {
+        for (int i = 0; (i < pInsn->detail->x86.op_count) && (!bResult); i++) {
+            cs_x86_op *pOperand = &(pInsn->detail->x86.operands[i]);
+
+            if (pOperand->type == X86_OP_MEM) {
+                if (pOperand->mem.base == X86_REG_RIP) {
+                    *pnAddress = pInsn->address + pInsn->size + pOperand->mem.disp;
+                    bResult = true;
+                } else if ((pOperand->mem.base == X86_REG_INVALID) && (pOperand->mem.index == X86_REG_INVALID)) {
+                    *pnAddress = pOperand->mem.disp;
+                    bResult = true;
+                }
+            } else if (pOperand->type == X86_OP_IMM) {
+                *pnAddress = pOperand->imm;
+                bResult = true;
+            }
+        }
+    } else if (csarch == CS_ARCH_ARM) {
+        for (int i = 0; (i < pInsn->detail->arm.op_count) && (!bResult); i++) {
+            cs_arm_op *pOperand = &(pInsn->detail->arm.operands[i]);
+
+            if ((pOperand->type == ARM_OP_MEM) && (pOperand->mem.base == ARM_REG_PC) && (pOperand->mem.index == ARM_REG_INVALID)) {
+                // Literal pool load, PC reads as the aligned address of the next but one instruction
+                *pnAddress = (quint32)(((pInsn->address + ((csmode & CS_MODE_THUMB) ? 4 : 8)) & ~3) + pOperand->mem.disp);
+                bResult = true;
+            }
+        }
+    } else if (csarch == CS_ARCH_ARM64) {
+        if ((pInsn->id == ARM64_INS_ADR) || (pInsn->id == ARM64_INS_ADRP)) {
+            for (int i = 0; (i < pInsn->detail->arm64.op_count) && (!bResult); i++) {
+                if (pInsn->detail->arm64.operands[i].type == ARM64_OP_IMM) {
+                    *pnAddress = pInsn->detail->arm64.operands[i].imm;
+                    bResult = true;
+                }
+            }
+        }
+    }
+
+    return bResult;
+}
+
+qint32 XDisasmArch::getOperandValues(cs_arch csarch, cs_mode csmode, cs_insn *pInsn, quint64 *pValues, qint32 nMaxValues) {
+    qint32 nResult = 0;
+
+    // Immediates are taken as encoded, so 0x9E3779B9 is found whatever its sign extension
+    if ((csarch == CS_ARCH_X86) && (pInsn->detail == 0)) {
+        X86_ENCODING encoding = {};
+
+        if (getX86Encoding(pInsn->bytes, pInsn->size, csmode, &encoding)) {
+            if (encoding.nImmSize && (!encoding.bIsRelative) && (nResult < nMaxValues)) {
+                quint64 nValue = 0;
+
+                for (qint32 i = 0; i < encoding.nImmSize; i++) {
+                    nValue |= ((quint64)pInsn->bytes[encoding.nImmOffset + i]) << (8 * i);
+                }
+
+                pValues[nResult++] = nValue;
+            }
+
+            // Short displacements are stack and field offsets
+            if ((encoding.nDispSize >= 4) && (!encoding.bIsRipRelative) && (nResult < nMaxValues)) {
+                pValues[nResult++] = *((quint32 *)(pInsn->bytes + encoding.nDispOffset));
+            }
+        }
+    } else if (csarch == CS_ARCH_X86) {
+        for (int i = 0; (i < pInsn->detail->x86.op_count) && (nResult < nMaxValues); i++) {
+            cs_x86_op *pOperand = &(pInsn->detail->x86.operands[i]);
+
+            if (pOperand->type == X86_OP_IMM) {
+                quint64 nValue = pOperand->imm;
+
+                if (pOperand->size < 8) {
+                    nValue &= ((((quint64)1) << (8 * pOperand->size)) - 1);
+                }
+
+                pValues[nResult++] = nValue;
+            } else if ((pOperand->type == X86_OP_MEM) && (pOperand->mem.base != X86_REG_RIP) && (pInsn->detail->x86.encoding.disp_size >= 4)) {
+                pValues[nResult++] = (quint32)pOperand->mem.disp;
+            }
+        }
+    } else if (csarch == CS_ARCH_ARM) {
+        for (int i = 0; (i < pInsn->detail->arm.op_count) && (nResult < nMaxValues); i++) {
+            if (pInsn->detail->arm.operands[i].type == ARM_OP_IMM) {
+                pValues[nResult++] = (quint32)pInsn->detail->arm.operands[i].imm;
+            }
+        }
+    } else if (csarch == CS_ARCH_ARM64) {
+        for (int i = 0; (i < pInsn->detail->arm64.op_count) && (nResult < nMaxValues); i++) {
+            if (pInsn->detail->arm64.operands[i].type == ARM64_OP_IMM) {
+                pValues[nResult++] = pInsn->detail->arm64.operands[i].imm;
+            }
+        }
+    } else if (csarch == CS_ARCH_MIPS) {
+        for (int i = 0; (i < pInsn->detail->mips.op_count) && (nResult < nMaxValues); i++) {
+            if (pInsn->detail->mips.operands[i].type == MIPS_OP_IMM) {
+                pValues[nResult++] = pInsn->detail->mips.operands[i].imm;
+            }
+        }
+    } else if (csarch == CS_ARCH_PPC) {
+        for (int i = 0; (i < pInsn->detail->ppc.op_count) && (nResult < nMaxValues); i++) {
+            if (pInsn->detail->ppc.operands[i].type == PPC_OP_IMM) {
+                pValues[nResult++] = pInsn->detail->ppc.operands[i].imm;
+            }
+        }
+    }
+
+    return nResult;
+}
+
+bool XDisasmArch::getEncoding(cs_arch csarch, cs_mode csmode, cs_insn *pInsn, qint32 *pnDispOffset, qint32 *pnDispSize, qint32 *pnImmOffset,
+                              qint32 *pnImmSize) {
+    bool bResult = false;
+
+    *pnDispOffset = 0;
+    *pnDispSize = 0;
+    *pnImmOffset = 0;
+    *pnImmSize = 0;
+
+    // Fixed-width encodings do not keep operands on byte boundaries
+    if ((csarch == CS_ARCH_X86) && (pInsn->detail == 0)) {
+        X86_ENCODING encoding = {};
+
+        if (getX86Encoding(pInsn->bytes, pInsn->size, csmode, &encoding)) {
+            *pnDispOffset = encoding.nDispOffset;
+            *pnDispSize = encoding.nDispSize;
+            *pnImmOffset = encoding.nImmOffset;
+            *pnImmSize = encoding.nImmSize;
+
+            bResult = true;
+        }
+    } else if (csarch == CS_ARCH_X86) {
+        *pnDispOffset = pInsn->detail->x86.encoding.disp_offset;
+        *pnDispSize = pInsn->detail->x86.encoding.disp_size;
+        *pnImmOffset = pInsn->detail->x86.encoding.imm_offset;
+        *pnImmSize = pInsn->detail->x86.encoding.imm_size;
+
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+bool XDisasmArch::getX86Encoding(const quint8 *pData, qint32 nSize, cs_mode csmode, X86_ENCODING *pEncoding) {
+    bool bResult = false;
+
+    *pEncoding = {};
+
+    bool bIs64 = (csmode & CS_MODE_64);
+    bool bIsOperandSize16 = (csmode & CS_MODE_16);
+    bool bIsAddressSize16 = (csmode & CS_MODE_16);
+
+    qint32 nIndex = 0;
+
+    while (nIndex < nSize) {
+        quint8 nByte = pData[nIndex];
+
+        if (nByte == 0x66) {
+            bIsOperandSize16 = !(csmode & CS_MODE_16);
+        } else if (nByte == 0x67) {
+            bIsAddressSize16 = (csmode & CS_MODE_32);
+        } else if ((nByte != 0xF0) && (nByte != 0xF2) && (nByte != 0xF3) && (nByte != 0x2E) && (nByte != 0x36) && (nByte != 0x3E) && (nByte != 0x26) &&
+                   (nByte != 0x64) && (nByte != 0x65)) {
+            break;
+        }
+
+        nIndex++;
+    }
+
+    bool bIsRexX = false;
+
+    if (bIs64 && (nIndex < nSize) && ((pData[nIndex] & 0xF0) == 0x40)) {
+        if (pData[nIndex] & 0x08) {
+            bIsOperandSize16 = false;  // REX.W
+        }
+
+        bIsRexX = (pData[nIndex] & 0x02);
+
+        nIndex++;
+    }
+
+    if (nIndex < nSize) {
+        quint8 nOpcode = pData[nIndex];
+        quint8 nNext = ((nIndex + 1) < nSize) ? pData[nIndex + 1] : 0;
+
+        if (nOpcode == 0x0F) {
+            pEncoding->nMap = 1;
+            pEncoding->nOpcode = nNext;
+            pEncoding->bIsModRM = (_X86_MODRM_0F[nNext >> 4] >> (nNext & 0x0F)) & 1;
+            nIndex += 2;
+
+            if ((nNext == 0x38) || (nNext == 0x3A)) {
+                pEncoding->nMap = (nNext == 0x38) ? 2 : 3;
+                pEncoding->nOpcode = ((nIndex) < nSize) ? pData[nIndex] : 0;
+                pEncoding->bIsModRM = true;
+                nIndex++;
+            }
+        } else if (((nOpcode == 0xC4) || (nOpcode == 0xC5) || (nOpcode == 0x62)) && (bIs64 || ((nNext & 0xC0) == 0xC0))) {
+            // VEX/EVEX; outside 64-bit mode the same bytes are les/lds/bound with a memory operand
+            qint32 nPrefixSize = (nOpcode == 0xC5) ? 2 : ((nOpcode == 0xC4) ? 3 : 4);
+
+            pEncoding->nMap = (nOpcode == 0xC5) ? 1 : (nNext & 0x03);
+            nIndex += nPrefixSize;
+            pEncoding->nOpcode = (nIndex < nSize) ? pData[nIndex] : 0;
+            pEncoding->bIsModRM = !((pEncoding->nMap == 1) && (pEncoding->nOpcode == 0x77));  // vzeroupper/vzeroall
+            nIndex++;
+        } else if ((nOpcode == 0x8F) && ((nNext & 0x1F) >= 8)) {
+            // XOP
+            pEncoding->nMap = 4;
+            nIndex += 3;
+            pEncoding->nOpcode = (nIndex < nSize) ? pData[nIndex] : 0;
+            pEncoding->bIsModRM = true;
+            nIndex++;
+        } else {
+            pEncoding->nMap = 0;
+            pEncoding->nOpcode = nOpcode;
+            pEncoding->bIsModRM = (_X86_MODRM[nOpcode >> 4] >> (nOpcode & 0x0F)) & 1;
+            nIndex++;
+        }
+
+        pEncoding->nOpcodeOffset = nIndex - 1;
+
+        if (pEncoding->bIsModRM && (nIndex < nSize)) {
+            quint8 nModRM = pData[nIndex];
+            quint8 nMod = nModRM >> 6;
+            quint8 nRM = nModRM & 0x07;
+
+            nIndex++;
+
+            if (bIsAddressSize16) {
+                if ((nMod == 0) && (nRM == 6)) {
+                    pEncoding->nDispSize = 2;
+                    pEncoding->bIsAbsoluteDisp = true;
+                } else if (nMod == 2) {
+                    pEncoding->nDispSize = 2;
+                } else if (nMod == 1) {
+                    pEncoding->nDispSize = 1;
+                }
+            } else if (nMod != 3) {
+                if ((nRM == 4) && (nIndex < nSize)) {
+                    quint8 nSIB = pData[nIndex];
+
+                    nIndex++;
+
+                    if ((nMod == 0) && ((nSIB & 0x07) == 5)) {
+                        pEncoding->nDispSize = 4;
+                        pEncoding->bIsAbsoluteDisp = (((nSIB >> 3) & 0x07) == 4) && (!bIsRexX);  // REX.X makes index 100 r12
+                    }
+                } else if ((nMod == 0) && (nRM == 5)) {
+                    pEncoding->nDispSize = 4;
+                    pEncoding->bIsRipRelative = bIs64;
+                    pEncoding->bIsAbsoluteDisp = !bIs64;
+                }
+
+                if (nMod == 1) {
+                    pEncoding->nDispSize = 1;
+                } else if (nMod == 2) {
+                    pEncoding->nDispSize = 4;
+                }
+            }
+
+            if (pEncoding->nDispSize) {
+                pEncoding->nDispOffset = nIndex;
+                nIndex += pEncoding->nDispSize;
+            }
+        } else if ((pEncoding->nMap == 0) && (pEncoding->nOpcode >= 0xA0) && (pEncoding->nOpcode <= 0xA3)) {
+            // mov moffs: the address is a displacement
+            pEncoding->nDispOffset = nIndex;
+            pEncoding->nDispSize = nSize - nIndex;
+            pEncoding->bIsAbsoluteDisp = true;
+            nIndex = nSize;
+        }
+
+        if (nIndex <= nSize) {
+            // Capstone already knows the length, so whatever follows is the immediate
+            if ((nIndex < nSize) && (!((pEncoding->nMap == 1) && (pEncoding->nOpcode == 0x0F)))) {
+                pEncoding->nImmOffset = nIndex;
+                pEncoding->nImmSize = nSize - nIndex;
+            }
+
+            pEncoding->bIsOperandSize16 = bIsOperandSize16;
+
+            if (pEncoding->nMap == 0) {
+                pEncoding->bIsRelative = ((pEncoding->nOpcode >= 0x70) && (pEncoding->nOpcode <= 0x7F)) ||
+                                         ((pEncoding->nOpcode >= 0xE0) && (pEncoding->nOpcode <= 0xE3)) || (pEncoding->nOpcode == 0xE8) ||
+                                         (pEncoding->nOpcode == 0xE9) || (pEncoding->nOpcode == 0xEB);
+            } else if (pEncoding->nMap == 1) {
+                pEncoding->bIsRelative = (pEncoding->nOpcode >= 0x80) && (pEncoding->nOpcode <= 0x8F);
+            }
+
+            pEncoding->bIsRelative = pEncoding->bIsRelative && pEncoding->nImmSize;
+
+            bResult = true;
+        }
+    }
+
+    return bResult;
+}
+
+void XDisasmArch::_setFlow(FLOW_TABLE *pFlowTable, const unsigned int *pList, qint32 nNumberOfRecords, quint8 nFlow) {
+    for (int i = 0; i < nNumberOfRecords; i++) {
+        if (pList[i] < (uint)pFlowTable->listFlows.size()) {
+            quint8 nValue = pFlowTable->listFlows.at(pList[i]) | nFlow;
+
+            if ((nValue & FLOW_END) && pFlowTable->bIsPredicated) {
+                nValue |= FLOW_PREDICATED;
+            }
+
+            pFlowTable->listFlows[pList[i]] = nValue;
+        }
+    }
+}
+
+quint8 XDisasmArch::_classify(FLOW_TABLE *pFlowTable, csh handle, cs_insn *pInsn) {
+    quint8 nResult = pFlowTable->listFlows.at(pInsn->id) | FLOW_KNOWN;
+
+    // The tables are completed by Capstone groups the first time an id is seen. A group jump may be conditional, so only the tables end a block
+    if (pInsn->detail) {
+        if (cs_insn_group(handle, pInsn, CS_GRP_JUMP)) {
+            nResult |= FLOW_JUMP;
+        }
+
+        if (cs_insn_group(handle, pInsn, CS_GRP_CALL)) {
+            nResult |= FLOW_CALL;
+        }
+
+        if (cs_insn_group(handle, pInsn, CS_GRP_RET)) {
+            nResult |= (FLOW_RET | FLOW_END);
+
+            if (pFlowTable->bIsPredicated) {
+                nResult |= FLOW_PREDICATED;
+            }
+        }
+
+    }
+
+    pFlowTable->listFlows[pInsn->id] = nResult;
+
+    return nResult;
+}
+
+bool XDisasmArch::_isPCWritten(csh handle, cs_insn *pInsn) {
+    bool bResult = false;
+
+    if (pInsn->detail) {
+        cs_regs regsRead;
+        cs_regs regsWrite;
+        uint8_t nNumberOfRead = 0;
+        uint8_t nNumberOfWrite = 0;
+
+        if (cs_regs_access(handle, pInsn, regsRead, &nNumberOfRead, regsWrite, &nNumberOfWrite) == CS_ERR_OK) {
+            for (int i = 0; (i < nNumberOfWrite) && (!bResult); i++) {
+                bResult = (regsWrite[i] == ARM_REG_PC);
+            }
+        }
+    }
+
+    return bResult;
+}
+
+bool XDisasmArch::_isUnconditional(cs_arch csarch, cs_insn *pInsn) {
+    bool bResult = true;
+
+    // ARM, ARM64 and PPC reuse one id for predicated and plain branches
+    if (pInsn->detail == 0) {
+        bResult = true;
+    } else if (csarch == CS_ARCH_ARM) {
+        bResult = (pInsn->detail->arm.cc == ARM_CC_AL) || (pInsn->detail->arm.cc == ARM_CC_INVALID);
+    } else if (csarch == CS_ARCH_ARM64) {
+        bResult = (pInsn->detail->arm64.cc == ARM64_CC_AL) || (pInsn->detail->arm64.cc == ARM64_CC_INVALID);
+    } else if (csarch == CS_ARCH_PPC) {
+        bResult = (pInsn->detail->ppc.bc == PPC_BC_INVALID);
+    }
+
+    return bResult;
+}
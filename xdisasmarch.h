@@ -0,0 +1,97 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef XDISASMARCH_H
+#define XDISASMARCH_H
+
+#include "capstone/capstone.h"
+#include "xformats.h"
+
+class XDisasmArch {
+public:
+    enum DP {
+        DP_DISPLAY = 0,  // mnemonic and operands only
+        DP_TRAVERSE,     // flow class and branch target
+        DP_FULL          // operand encoding
+    };
+
+    enum FLOW {
+        FLOW_JUMP = 0x01,
+        FLOW_CALL = 0x02,
+        FLOW_RET = 0x04,
+        FLOW_END = 0x08,         // no fall through
+        FLOW_PREDICATED = 0x10,  // FLOW_END only if the condition code is "always"
+        FLOW_KNOWN = 0x80
+    };
+
+    struct ARCH_RECORD {
+        cs_arch csarch;
+        quint32 nNumberOfOpcodes;
+        const unsigned int *pJumps;
+        qint32 nNumberOfJumps;
+        const unsigned int *pCalls;
+        qint32 nNumberOfCalls;
+        const unsigned int *pEndBranches;
+        qint32 nNumberOfEndBranches;
+        qint32 nDelaySlots;
+        bool bIsPredicated;
+    };
+
+    struct X86_ENCODING {
+        qint32 nOpcodeOffset;
+        qint32 nMap;  // 0 - one byte, 1 - 0F, 2 - 0F38, 3 - 0F3A, 4 - other
+        quint8 nOpcode;
+        bool bIsModRM;
+        qint32 nDispOffset;
+        qint32 nDispSize;
+        qint32 nImmOffset;
+        qint32 nImmSize;
+        bool bIsOperandSize16;
+        bool bIsRelative;
+        bool bIsRipRelative;
+        bool bIsAbsoluteDisp;  // no base and no index register, the displacement is the address
+    };
+
+    struct FLOW_TABLE {
+        cs_arch csarch;
+        bool bIsPredicated;
+        QVector<quint8> listFlows;  // indexed by instruction id
+    };
+
+    static bool getCsArchMode(XBinary::_MEMORY_MAP *pMemoryMap, cs_arch *pCsArch, cs_mode *pCsMode);
+    static bool openHandle(cs_arch csarch, cs_mode csmode, DP dp, csh *pHandle);
+    static const ARCH_RECORD *getArchRecord(cs_arch csarch);
+    static void initFlowTable(FLOW_TABLE *pFlowTable, cs_arch csarch);
+    static quint32 getFlow(FLOW_TABLE *pFlowTable, csh handle, cs_insn *pInsn);
+    static qint32 getDelaySlots(cs_arch csarch);
+    static bool getBranchAddress(cs_arch csarch, cs_mode csmode, cs_insn *pInsn, qint64 *pnAddress);
+    static bool getDataAddress(cs_arch csarch, cs_mode csmode, cs_insn *pInsn, qint64 *pnAddress);
+    static qint32 getOperandValues(cs_arch csarch, cs_mode csmode, cs_insn *pInsn, quint64 *pValues, qint32 nMaxValues);
+    static bool getEncoding(cs_arch csarch, cs_mode csmode, cs_insn *pInsn, qint32 *pnDispOffset, qint32 *pnDispSize, qint32 *pnImmOffset, qint32 *pnImmSize);
+    static bool getX86Encoding(const quint8 *pData, qint32 nSize, cs_mode csmode, X86_ENCODING *pEncoding);
+
+private:
+    static void _setFlow(FLOW_TABLE *pFlowTable, const unsigned int *pList, qint32 nNumberOfRecords, quint8 nFlow);
+    static quint8 _classify(FLOW_TABLE *pFlowTable, csh handle, cs_insn *pInsn);
+    static bool _isUnconditional(cs_arch csarch, cs_insn *pInsn);
+    static bool _isPCWritten(csh handle, cs_insn *pInsn);
+};
+
+#endif  // XDISASMARCH_H
@@ -0,0 +1,364 @@
+// Copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "xdisasmcolumns.h"
+
+XDisasmColumns::XDisasmColumns(QIODevice *pDevice) {
+    g_pDevice = pDevice;
+    g_nOffset = 0;
+    g_bIsValid = true;
+    g_currentColumn = {};
+}
+
+bool XDisasmColumns::write(XDisasm::STATS *pStats, bool *pbStop) {
+    // Header
+    _appendData("XDCOLS\0\0", 8);
+    _writeValue(N_VERSION, 4);
+    _writeValue(pStats->csarch, 4);
+    _writeValue(pStats->csmode, 4);
+    _writeValue(0, 4);
+    _writeValue(pStats->nImageBase, 8);
+    _writeValue(pStats->nEntryPointAddress, 8);
+
+    // Instruction ids are kept in the opcode index, one posting list per id
+    QVector<QPair<qint64, quint32>> listOpcodeIDs;
+    listOpcodeIDs.reserve(pStats->opcodeIndex.listAddresses.count());
+
+    int nNumberOfKeys = pStats->opcodeIndex.listKeys.count();
+
+    for (int i = 0; i < nNumberOfKeys; i++) {
+        for (qint32 j = pStats->opcodeIndex.listOffsets.at(i); j < pStats->opcodeIndex.listOffsets.at(i + 1); j++) {
+            listOpcodeIDs.append(qMakePair(pStats->opcodeIndex.listAddresses.at(j), (quint32)pStats->opcodeIndex.listKeys.at(i)));
+        }
+    }
+
+    std::sort(listOpcodeIDs.begin(), listOpcodeIDs.end());
+
+    QList<qint64> listInsnAddresses;
+    QList<qint64> listDataAddresses;
+
+    QMapIterator<qint64, XDisasm::RECORD> iRecords(pStats->mapRecords);
+    while (iRecords.hasNext() && (!(*pbStop))) {
+        iRecords.next();
+
+        if (iRecords.value().type == XDisasm::RECORD_TYPE_OPCODE) {
+            listInsnAddresses.append(iRecords.key());
+        } else if (iRecords.value().type == XDisasm::RECORD_TYPE_DATA) {
+            listDataAddresses.append(iRecords.key());
+        }
+    }
+
+    int nNumberOfInsns = listInsnAddresses.count();
+
+    _beginColumn(COLUMN_INSN_ADDRESS, 8);
+
+    for (int i = 0; (i < nNumberOfInsns) && (!(*pbStop)); i++) {
+        _appendValue(listInsnAddresses.at(i));
+    }
+
+    _endColumn();
+
+    _beginColumn(COLUMN_INSN_SIZE, 1);
+
+    for (int i = 0; (i < nNumberOfInsns) && (!(*pbStop)); i++) {
+        _appendValue(pStats->mapRecords.value(listInsnAddresses.at(i)).nSize);
+    }
+
+    _endColumn();
+
+    _beginColumn(COLUMN_INSN_OPCODEID, 4);
+
+    int nNumberOfOpcodeIDs = listOpcodeIDs.count();
+
+    for (int i = 0, j = 0; (i < nNumberOfInsns) && (!(*pbStop)); i++) {
+        while ((j < nNumberOfOpcodeIDs) && (listOpcodeIDs.at(j).first < listInsnAddresses.at(i))) {
+            j++;
+        }
+
+        quint32 nOpcodeID = 0;
+
+        if ((j < nNumberOfOpcodeIDs) && (listOpcodeIDs.at(j).first == listInsnAddresses.at(i))) {
+            nOpcodeID = listOpcodeIDs.at(j).second;
+        }
+
+        _appendValue(nOpcodeID);
+    }
+
+    _endColumn();
+
+    // Mnemonic dictionary
+    QList<QString> listNames;
+
+    csh disasm_handle = 0;
+
+    if (XDisasmArch::openHandle(pStats->csarch, pStats->csmode, XDisasmArch::DP_DISPLAY, &disasm_handle)) {
+        for (int i = 0; i < nNumberOfKeys; i++) {
+            const char *pName = cs_insn_name(disasm_handle, (unsigned int)pStats->opcodeIndex.listKeys.at(i));
+
+            listNames.append(pName ? QString(pName) : QString());
+        }
+
+        cs_close(&disasm_handle);
+    }
+
+    _beginColumn(COLUMN_MNEMONIC_OPCODEID, 4);
+
+    for (int i = 0; i < nNumberOfKeys; i++) {
+        _appendValue(pStats->opcodeIndex.listKeys.at(i));
+    }
+
+    _endColumn();
+
+    _writeNames(COLUMN_MNEMONIC_NAMES, COLUMN_MNEMONIC_NAMEOFFSET, &listNames);
+
+    // Data
+    int nNumberOfData = listDataAddresses.count();
+
+    _beginColumn(COLUMN_DATA_ADDRESS, 8);
+
+    for (int i = 0; (i < nNumberOfData) && (!(*pbStop)); i++) {
+        _appendValue(listDataAddresses.at(i));
+    }
+
+    _endColumn();
+
+    _beginColumn(COLUMN_DATA_SIZE, 8);
+
+    for (int i = 0; (i < nNumberOfData) && (!(*pbStop)); i++) {
+        _appendValue(pStats->mapRecords.value(listDataAddresses.at(i)).nSize);
+    }
+
+    _endColumn();
+
+    _beginColumn(COLUMN_DATA_TYPE, 1);
+
+    for (int i = 0; (i < nNumberOfData) && (!(*pbStop)); i++) {
+        _appendValue(pStats->mapRecords.value(listDataAddresses.at(i)).dataType);
+    }
+
+    _endColumn();
+
+    // References
+    const XDisasm::XREF_INDEX *pXrefs = &(pStats->xrefsFrom);
+
+    int nNumberOfKeys = pXrefs->listKeys.count();
+    int nNumberOfXrefs = pXrefs->listAddresses.count();
+
+    _beginColumn(COLUMN_XREF_FROM, 8);
+
+    for (int i = 0; (i < nNumberOfKeys) && (!(*pbStop)); i++) {
+        for (qint32 j = pXrefs->listOffsets.at(i); j < pXrefs->listOffsets.at(i + 1); j++) {
+            _appendValue(pXrefs->listKeys.at(i));
+        }
+    }
+
+    _endColumn();
+
+    _beginColumn(COLUMN_XREF_TO, 8);
+
+    for (int i = 0; (i < nNumberOfXrefs) && (!(*pbStop)); i++) {
+        _appendValue(pXrefs->listAddresses.at(i));
+    }
+
+    _endColumn();
+
+    _beginColumn(COLUMN_XREF_TYPE, 1);
+
+    for (int i = 0; (i < nNumberOfXrefs) && (!(*pbStop)); i++) {
+        _appendValue(pXrefs->listTypes.at(i));
+    }
+
+    _endColumn();
+
+    // Labels
+    listNames.clear();
+
+    _beginColumn(COLUMN_LABEL_ADDRESS, 8);
+
+    QMapIterator<qint64, XDisasm::LABEL> iLabels(pStats->mapLabels);
+    while (iLabels.hasNext() && (!(*pbStop))) {
+        iLabels.next();
+
+        _appendValue(iLabels.key());
+
+        listNames.append(XDisasm::getLabelString(pStats, iLabels.key(), iLabels.value()));
+    }
+
+    _endColumn();
+
+    _beginColumn(COLUMN_LABEL_TYPE, 1);
+
+    iLabels.toFront();
+    while (iLabels.hasNext() && (!(*pbStop))) {
+        iLabels.next();
+
+        _appendValue(iLabels.value().type);
+    }
+
+    _endColumn();
+
+    _writeNames(COLUMN_LABEL_NAMES, COLUMN_LABEL_NAMEOFFSET, &listNames);
+
+    // Sections
+    listNames.clear();
+
+    int nNumberOfSections = pStats->memoryMap.listRecords.count();
+
+    _beginColumn(COLUMN_SECTION_ADDRESS, 8);
+
+    for (int i = 0; i < nNumberOfSections; i++) {
+        _appendValue(pStats->memoryMap.listRecords.at(i).nAddress);
+
+        listNames.append(pStats->memoryMap.listRecords.at(i).sName);
+    }
+
+    _endColumn();
+
+    _beginColumn(COLUMN_SECTION_OFFSET, 8);
+
+    for (int i = 0; i < nNumberOfSections; i++) {
+        _appendValue(pStats->memoryMap.listRecords.at(i).nOffset);
+    }
+
+    _endColumn();
+
+    _beginColumn(COLUMN_SECTION_SIZE, 8);
+
+    for (int i = 0; i < nNumberOfSections; i++) {
+        _appendValue(pStats->memoryMap.listRecords.at(i).nSize);
+    }
+
+    _endColumn();
+
+    _writeNames(COLUMN_SECTION_NAMES, COLUMN_SECTION_NAMEOFFSET, &listNames);
+
+    // TOC and footer
+    _align();
+
+    qint64 nTOCOffset = g_nOffset + g_baBuffer.size();
+
+    int nNumberOfColumns = g_listTOC.count();
+
+    for (int i = 0; i < nNumberOfColumns; i++) {
+        _writeValue(g_listTOC.at(i).column, 4);
+        _writeValue(g_listTOC.at(i).nElementSize, 4);
+        _writeValue(g_listTOC.at(i).nOffset, 8);
+        _writeValue(g_listTOC.at(i).nCount, 8);
+    }
+
+    _writeValue(nTOCOffset, 8);
+    _writeValue(nNumberOfColumns, 4);
+    _writeValue(N_MAGIC, 4);
+
+    _flush();
+
+    return g_bIsValid && (!(*pbStop));
+}
+
+void XDisasmColumns::_beginColumn(XDisasmColumns::COLUMN column, quint32 nElementSize) {
+    _align();
+
+    g_currentColumn = {};
+    g_currentColumn.column = column;
+    g_currentColumn.nElementSize = nElementSize;
+    g_currentColumn.nOffset = g_nOffset + g_baBuffer.size();
+}
+
+void XDisasmColumns::_appendValue(quint64 nValue) {
+    _writeValue(nValue, g_currentColumn.nElementSize);
+
+    g_currentColumn.nCount++;
+}
+
+void XDisasmColumns::_writeValue(quint64 nValue, qint32 nSize) {
+    char buffer[8];
+
+    qToLittleEndian(nValue, (uchar *)buffer);
+
+    _appendData(buffer, nSize);
+}
+
+void XDisasmColumns::_appendData(const char *pData, qint64 nSize) {
+    g_baBuffer.append(pData, nSize);
+
+    if (g_baBuffer.size() >= N_BUFFERSIZE) {
+        _flush();
+    }
+}
+
+void XDisasmColumns::_endColumn() {
+    g_listTOC.append(g_currentColumn);
+
+    g_currentColumn = {};
+}
+
+void XDisasmColumns::_writeNames(XDisasmColumns::COLUMN columnNames, XDisasmColumns::COLUMN columnOffsets, const QList<QString> *pListNames) {
+    // UTF-8 names back to back, name i is [offsets[i], offsets[i+1])
+    QVector<quint32> listOffsets;
+
+    int nNumberOfNames = pListNames->count();
+
+    _beginColumn(columnNames, 1);
+
+    quint32 nNameOffset = 0;
+
+    for (int i = 0; i < nNumberOfNames; i++) {
+        QByteArray baName = pListNames->at(i).toUtf8();
+
+        listOffsets.append(nNameOffset);
+
+        _appendData(baName.constData(), baName.size());
+
+        nNameOffset += baName.size();
+    }
+
+    listOffsets.append(nNameOffset);
+
+    g_currentColumn.nCount = nNameOffset;
+
+    _endColumn();
+
+    _beginColumn(columnOffsets, 4);
+
+    for (int i = 0; i <= nNumberOfNames; i++) {
+        _appendValue(listOffsets.at(i));
+    }
+
+    _endColumn();
+}
+
+void XDisasmColumns::_align() {
+    qint64 nPadding = (8 - ((g_nOffset + g_baBuffer.size()) % 8)) % 8;
+
+    if (nPadding) {
+        _appendData("\0\0\0\0\0\0\0", nPadding);
+    }
+}
+
+void XDisasmColumns::_flush() {
+    if (g_baBuffer.size()) {
+        if (g_bIsValid) {
+            g_bIsValid = (g_pDevice->write(g_baBuffer) == g_baBuffer.size());
+        }
+
+        g_nOffset += g_baBuffer.size();
+        g_baBuffer.clear();
+    }
+}
@@ -0,0 +1,88 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef XDISASMCOLUMNS_H
+#define XDISASMCOLUMNS_H
+
+#include "xdisasm.h"
+
+// Columnar dump of XDisasm::STATS, little endian, every column 8-byte aligned:
+// header (magic, version, arch, mode, reserved, image base, entry point) | columns |
+// TOC (id, element size, offset, count per column) | TOC offset, column count, magic
+class XDisasmColumns {
+    static const int N_VERSION = 1;
+    static const quint32 N_MAGIC = 0x4F434458;  // "XDCO"
+    static const int N_BUFFERSIZE = 0x10000;
+
+public:
+    enum COLUMN {
+        COLUMN_UNKNOWN = 0,
+        COLUMN_INSN_ADDRESS,
+        COLUMN_INSN_SIZE,
+        COLUMN_INSN_OPCODEID,
+        COLUMN_MNEMONIC_OPCODEID,  // dictionary of the ids in COLUMN_INSN_OPCODEID
+        COLUMN_MNEMONIC_NAMEOFFSET,
+        COLUMN_MNEMONIC_NAMES,
+        COLUMN_DATA_ADDRESS,
+        COLUMN_DATA_SIZE,
+        COLUMN_DATA_TYPE,
+        COLUMN_XREF_FROM,
+        COLUMN_XREF_TO,
+        COLUMN_XREF_TYPE,
+        COLUMN_LABEL_ADDRESS,
+        COLUMN_LABEL_TYPE,
+        COLUMN_LABEL_NAMEOFFSET,
+        COLUMN_LABEL_NAMES,
+        COLUMN_SECTION_ADDRESS,
+        COLUMN_SECTION_OFFSET,
+        COLUMN_SECTION_SIZE,
+        COLUMN_SECTION_NAMEOFFSET,
+        COLUMN_SECTION_NAMES
+    };
+
+    XDisasmColumns(QIODevice *pDevice);
+    bool write(XDisasm::STATS *pStats, bool *pbStop);
+
+private:
+    struct TOC_RECORD {
+        COLUMN column;
+        quint32 nElementSize;
+        qint64 nOffset;
+        qint64 nCount;
+    };
+
+    void _beginColumn(COLUMN column, quint32 nElementSize);
+    void _appendValue(quint64 nValue);
+    void _writeValue(quint64 nValue, qint32 nSize);
+    void _appendData(const char *pData, qint64 nSize);
+    void _endColumn();
+    void _writeNames(COLUMN columnNames, COLUMN columnOffsets, const QList<QString> *pListNames);
+    void _align();
+    void _flush();
+
+    QIODevice *g_pDevice;
+    QByteArray g_baBuffer;
+    qint64 g_nOffset;  // of the end of the buffer
+    bool g_bIsValid;
+    QList<TOC_RECORD> g_listTOC;
+    TOC_RECORD g_currentColumn;
+};
+
+#endif  // XDISASMCOLUMNS_H
@@ -0,0 +1,176 @@
+// Copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "xdisasmfingerprints.h"
+
+XDisasmFingerprints::XDisasmFingerprints() {
+    clear();
+}
+
+void XDisasmFingerprints::clear() {
+    g_listEntries.clear();
+    g_mapEdges.clear();
+    g_listWildcards.clear();
+    g_listNodeEntries.clear();
+
+    // root
+    g_listWildcards.append(-1);
+    g_listNodeEntries.append(QVector<qint32>());
+}
+
+bool XDisasmFingerprints::load(QString sFileName) {
+    bool bResult = false;
+
+    QFile file;
+    file.setFileName(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        while (!file.atEnd()) {
+            addEntry(QString::fromUtf8(file.readLine()));
+        }
+
+        file.close();
+
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+bool XDisasmFingerprints::addEntry(QString sLine) {
+    bool bResult = false;
+
+    // name hash size pattern, as written by XDisasm::processExportFingerprints
+    QStringList listParts = sLine.simplified().split(QChar(' '));
+
+    int nNumberOfParts = listParts.count();
+
+    if (nNumberOfParts >= 4) {
+        ENTRY entry = {};
+
+        bool bHash = false;
+        bool bSize = false;
+
+        entry.sName = QStringList(listParts.mid(0, nNumberOfParts - 3)).join(QChar(' '));
+        entry.nHash = listParts.at(nNumberOfParts - 3).toULongLong(&bHash, 16);
+        entry.nSize = listParts.at(nNumberOfParts - 2).toLongLong(&bSize, 16);
+
+        QString sPattern = listParts.at(nNumberOfParts - 1);
+
+        int nPatternSize = sPattern.size();
+
+        entry.nPatternSize = nPatternSize / 2;
+
+        if (bHash && bSize && nPatternSize && ((nPatternSize % 2) == 0)) {
+            qint32 nIndex = g_listEntries.count();
+            qint32 nNode = 0;
+
+            bResult = true;
+
+            for (int i = 0; (i < nPatternSize) && bResult; i += 2) {
+                QString sByte = sPattern.mid(i, 2);
+
+                qint32 nNext = -1;
+
+                if (sByte == "..") {
+                    nNext = g_listWildcards.at(nNode);
+
+                    if (nNext == -1) {
+                        nNext = g_listWildcards.count();
+                        g_listWildcards[nNode] = nNext;
+                    }
+                } else {
+                    bool bByte = false;
+                    quint8 nByte = (quint8)sByte.toUInt(&bByte, 16);
+
+                    if (bByte) {
+                        qint64 nKey = ((qint64)nNode << 8) | nByte;
+
+                        nNext = g_mapEdges.value(nKey, -1);
+
+                        if (nNext == -1) {
+                            nNext = g_listWildcards.count();
+                            g_mapEdges.insert(nKey, nNext);
+                        }
+                    } else {
+                        bResult = false;
+                    }
+                }
+
+                if (nNext == g_listWildcards.count()) {
+                    g_listWildcards.append(-1);
+                    g_listNodeEntries.append(QVector<qint32>());
+                }
+
+                if (bResult) {
+                    nNode = nNext;
+                }
+            }
+
+            if (bResult) {
+                g_listEntries.append(entry);
+                g_listNodeEntries[nNode].append(nIndex);
+            }
+        }
+    }
+
+    return bResult;
+}
+
+bool XDisasmFingerprints::isEmpty() {
+    return g_listEntries.isEmpty();
+}
+
+QList<qint32> XDisasmFingerprints::getCandidates(const char *pData, qint32 nDataSize) {
+    QList<qint32> listResult;
+
+    // Walk literal and wildcard edges together
+    QVector<QPair<qint32, qint32>> listStack;
+    listStack.append(QPair<qint32, qint32>(0, 0));
+
+    while (!listStack.isEmpty()) {
+        QPair<qint32, qint32> record = listStack.takeLast();
+
+        qint32 nNode = record.first;
+        qint32 nDepth = record.second;
+
+        listResult.append(g_listNodeEntries.at(nNode).toList());
+
+        if (nDepth < nDataSize) {
+            qint32 nNext = g_mapEdges.value(((qint64)nNode << 8) | (quint8)(pData[nDepth]), -1);
+
+            if (nNext != -1) {
+                listStack.append(QPair<qint32, qint32>(nNext, nDepth + 1));
+            }
+
+            nNext = g_listWildcards.at(nNode);
+
+            if (nNext != -1) {
+                listStack.append(QPair<qint32, qint32>(nNext, nDepth + 1));
+            }
+        }
+    }
+
+    return listResult;
+}
+
+XDisasmFingerprints::ENTRY XDisasmFingerprints::getEntry(qint32 nIndex) {
+    return g_listEntries.at(nIndex);
+}
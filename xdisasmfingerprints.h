@@ -0,0 +1,50 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef XDISASMFINGERPRINTS_H
+#define XDISASMFINGERPRINTS_H
+
+#include "xformats.h"
+
+class XDisasmFingerprints {
+public:
+    struct ENTRY {
+        QString sName;
+        quint64 nHash;
+        qint64 nSize;
+        qint32 nPatternSize;
+    };
+
+    XDisasmFingerprints();
+    void clear();
+    bool load(QString sFileName);
+    bool addEntry(QString sLine);
+    bool isEmpty();
+    QList<qint32> getCandidates(const char *pData, qint32 nDataSize);
+    ENTRY getEntry(qint32 nIndex);
+
+private:
+    QList<ENTRY> g_listEntries;
+    QHash<qint64, qint32> g_mapEdges;  // (node << 8) | byte -> node
+    QVector<qint32> g_listWildcards;   // node -> node, -1 if none
+    QVector<QVector<qint32>> g_listNodeEntries;
+};
+
+#endif  // XDISASMFINGERPRINTS_H
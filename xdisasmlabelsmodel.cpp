@@ -0,0 +1,239 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "xdisasmlabelsmodel.h"
+
+XDisasmLabelsModel::XDisasmLabelsModel(XDisasm::STATS *pStats, QObject *pParent) : QAbstractTableModel(pParent) {
+    this->g_pStats = pStats;
+
+    g_nSortColumn = LMCOLUMN_ADDRESS;
+    g_sortOrder = Qt::AscendingOrder;
+    g_bSubstring = false;
+
+    int nNumberOfLabels = pStats->mapLabels.count();
+
+    g_listLabels.reserve(nNumberOfLabels);
+    g_listRows.reserve(nNumberOfLabels);
+
+    for (LABEL_ITERATOR iter = pStats->mapLabels.constBegin(); iter != pStats->mapLabels.constEnd(); iter++) {
+        g_listRows.append(g_listLabels.count());
+        g_listLabels.append(iter);
+    }
+}
+
+QVariant XDisasmLabelsModel::headerData(int section, Qt::Orientation orientation, int nRole) const {
+    QVariant result;
+
+    if (orientation == Qt::Horizontal) {
+        if (nRole == Qt::DisplayRole) {
+            switch (section) {
+                case LMCOLUMN_NAME:
+                    result = tr("Name");
+                    break;
+                case LMCOLUMN_ADDRESS:
+                    result = tr("Address");
+                    break;
+            }
+        }
+    }
+
+    return result;
+}
+
+int XDisasmLabelsModel::rowCount(const QModelIndex &parent) const {
+    int nResult = g_listRows.count();
+
+    if (parent.isValid()) {
+        nResult = 0;
+    }
+
+    return nResult;
+}
+
+int XDisasmLabelsModel::columnCount(const QModelIndex &parent) const {
+    int nResult = __LMCOLUMN_SIZE;
+
+    if (parent.isValid()) {
+        nResult = 0;
+    }
+
+    return nResult;
+}
+
+QVariant XDisasmLabelsModel::data(const QModelIndex &index, int nRole) const {
+    QVariant result;
+
+    if (index.isValid() && (nRole == Qt::DisplayRole)) {
+        // Text is only made for visible rows
+        LABEL_ITERATOR iter = g_listLabels.at(g_listRows.at(index.row()));
+
+        if (index.column() == LMCOLUMN_NAME) {
+            result = _getName(g_listRows.at(index.row()));
+        } else if (index.column() == LMCOLUMN_ADDRESS) {
+            result = XBinary::valueToHex(g_pStats->memoryMap.mode, iter.key());
+        }
+    }
+
+    return result;
+}
+
+void XDisasmLabelsModel::sort(int nColumn, Qt::SortOrder order) {
+    g_nSortColumn = nColumn;
+    g_sortOrder = order;
+
+    _updateRows();
+}
+
+void XDisasmLabelsModel::setFilter(QString sFilter, bool bSubstring) {
+    QString sOldFilter = g_sFilter;
+    bool bOldSubstring = g_bSubstring;
+
+    g_sFilter = sFilter;
+    g_bSubstring = bSubstring;
+
+    if (bSubstring && bOldSubstring && (sOldFilter != "") && sFilter.contains(sOldFilter, Qt::CaseInsensitive)) {
+        // Typing on narrows the rows already shown
+        QVector<qint32> listRows;
+
+        int nNumberOfRows = g_listRows.count();
+
+        for (int i = 0; i < nNumberOfRows; i++) {
+            if (_getName(g_listRows.at(i)).contains(sFilter, Qt::CaseInsensitive)) {
+                listRows.append(g_listRows.at(i));
+            }
+        }
+
+        beginResetModel();
+        g_listRows = listRows;
+        endResetModel();
+    } else {
+        _updateRows();
+    }
+}
+
+qint64 XDisasmLabelsModel::getAddress(int nRow) {
+    return g_listLabels.at(g_listRows.at(nRow)).key();
+}
+
+QString XDisasmLabelsModel::_getName(qint32 nIndex) const {
+    QString sResult;
+
+    if (nIndex < g_listNames.count()) {
+        sResult = g_listNames.at(nIndex);
+    } else {
+        LABEL_ITERATOR iter = g_listLabels.at(nIndex);
+
+        sResult = XDisasm::getLabelString(g_pStats, iter.key(), iter.value());
+    }
+
+    return sResult;
+}
+
+void XDisasmLabelsModel::_buildNameIndex() {
+    if (g_listNameIndex.count() != g_listLabels.count()) {
+        int nNumberOfLabels = g_listLabels.count();
+
+        // Generated names are made once here instead of on every compare
+        g_listNames.resize(nNumberOfLabels);
+        g_listNameIndex.resize(nNumberOfLabels);
+
+        for (int i = 0; i < nNumberOfLabels; i++) {
+            g_listNames[i] = XDisasm::getLabelString(g_pStats, g_listLabels.at(i).key(), g_listLabels.at(i).value());
+            g_listNameIndex[i] = i;
+        }
+
+        const QVector<QString> *pListNames = &g_listNames;
+
+        std::stable_sort(g_listNameIndex.begin(), g_listNameIndex.end(), [pListNames](qint32 nLeft, qint32 nRight) {
+            return QString::compare(pListNames->at(nLeft), pListNames->at(nRight), Qt::CaseInsensitive) < 0;
+        });
+    }
+}
+
+QVector<qint32> XDisasmLabelsModel::_getOrder() {
+    QVector<qint32> listResult;
+
+    if (g_nSortColumn == LMCOLUMN_NAME) {
+        _buildNameIndex();
+
+        listResult = g_listNameIndex;
+    } else {
+        int nNumberOfLabels = g_listLabels.count();
+
+        listResult.resize(nNumberOfLabels);
+
+        for (int i = 0; i < nNumberOfLabels; i++) {
+            listResult[i] = i;
+        }
+    }
+
+    return listResult;
+}
+
+void XDisasmLabelsModel::_updateRows() {
+    QVector<qint32> listRows;
+
+    if (g_sFilter == "") {
+        listRows = _getOrder();
+    } else if (g_bSubstring) {
+        _buildNameIndex();
+
+        QVector<qint32> listOrder = _getOrder();
+
+        int nNumberOfLabels = listOrder.count();
+
+        for (int i = 0; i < nNumberOfLabels; i++) {
+            if (g_listNames.at(listOrder.at(i)).contains(g_sFilter, Qt::CaseInsensitive)) {
+                listRows.append(listOrder.at(i));
+            }
+        }
+    } else {
+        // Prefix matches are one range of the name index
+        _buildNameIndex();
+
+        QString sFilter = g_sFilter;
+        const QVector<QString> *pListNames = &g_listNames;
+
+        QVector<qint32>::const_iterator iterBegin =
+            std::lower_bound(g_listNameIndex.constBegin(), g_listNameIndex.constEnd(), sFilter, [pListNames](qint32 nIndex, const QString &sValue) {
+                return QString::compare(pListNames->at(nIndex), sValue, Qt::CaseInsensitive) < 0;
+            });
+
+        for (QVector<qint32>::const_iterator iter = iterBegin; iter != g_listNameIndex.constEnd(); iter++) {
+            if (!g_listNames.at(*iter).startsWith(sFilter, Qt::CaseInsensitive)) {
+                break;
+            }
+
+            listRows.append(*iter);
+        }
+
+        if (g_nSortColumn != LMCOLUMN_NAME) {
+            std::sort(listRows.begin(), listRows.end());
+        }
+    }
+
+    if (g_sortOrder == Qt::DescendingOrder) {
+        std::reverse(listRows.begin(), listRows.end());
+    }
+
+    beginResetModel();
+    g_listRows = listRows;
+    endResetModel();
+}
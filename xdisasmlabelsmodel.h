@@ -0,0 +1,68 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef XDISASMLABELSMODEL_H
+#define XDISASMLABELSMODEL_H
+
+#include <QAbstractTableModel>
+
+#include "xdisasm.h"
+
+class XDisasmLabelsModel : public QAbstractTableModel {
+    Q_OBJECT
+
+    typedef QMap<qint64, XDisasm::LABEL>::const_iterator LABEL_ITERATOR;
+
+public:
+    enum LMCOLUMN {
+        LMCOLUMN_NAME = 0,
+        LMCOLUMN_ADDRESS,
+        __LMCOLUMN_SIZE
+    };
+
+    explicit XDisasmLabelsModel(XDisasm::STATS *pStats, QObject *pParent);
+    // Header:
+    QVariant headerData(int section, Qt::Orientation orientation, int nRole = Qt::DisplayRole) const override;
+    // Basic functionality:
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int nRole = Qt::DisplayRole) const override;
+    void sort(int nColumn, Qt::SortOrder order = Qt::AscendingOrder) override;
+    void setFilter(QString sFilter, bool bSubstring);
+    qint64 getAddress(int nRow);
+
+private:
+    QString _getName(qint32 nIndex) const;
+    void _buildNameIndex();
+    QVector<qint32> _getOrder();
+    void _updateRows();
+
+    XDisasm::STATS *g_pStats;
+    QVector<LABEL_ITERATOR> g_listLabels;  // address order, points into the label store
+    QVector<QString> g_listNames;          // built with the name index
+    QVector<qint32> g_listNameIndex;       // labels by name, built on first use
+    QVector<qint32> g_listRows;
+    int g_nSortColumn;
+    Qt::SortOrder g_sortOrder;
+    QString g_sFilter;
+    bool g_bSubstring;
+};
+
+#endif  // XDISASMLABELSMODEL_H
@@ -25,11 +25,17 @@ XDisasmModel::XDisasmModel(QIODevice *pDevice, XDisasm::STATS *pStats, SHOWOPTIO
     this->g_pStats = pStats;
     this->g_pShowOptions = pShowOptions;
 
+    g_disasm_handle = 0;
+    g_pInsn = 0;
     g_bDisasmInit = false;
 }
 
 XDisasmModel::~XDisasmModel() {
-    if (g_bDisasmInit) {
+    if (g_pInsn) {
+        cs_free(g_pInsn, 1);
+    }
+
+    if (g_disasm_handle) {
         cs_close(&g_disasm_handle);
     }
 }
@@ -69,7 +75,8 @@ int XDisasmModel::rowCount(const QModelIndex &parent) const {
 
     //    return XBinary::getTotalVirtualSize(&(pStats->listMM));
     //    return pStats->mapVB.count();
-    return getPositionCount();
+    // Item views count rows in int, XDisasmView reads positions directly
+    return (int)qMin(getPositionCount(), (qint64)INT_MAX);
 }
 
 int XDisasmModel::columnCount(const QModelIndex &parent) const {
@@ -93,24 +100,8 @@ QVariant XDisasmModel::data(const QModelIndex &index, int nRole) const {
     if (nRole == Qt::DisplayRole) {
         XDisasmModel *_this = const_cast<XDisasmModel *>(this);
 
-        VEIW_RECORD vrRecord = {};
-
-        int nRow = index.row();
-
-        if (_this->g_quRecords.contains(nRow)) {
-            vrRecord = _this->g_mapRecords.value(nRow);
-        } else {
-            vrRecord = _this->getViewRecord(nRow);
-
-            _this->g_quRecords.enqueue(nRow);
-            _this->g_mapRecords.insert(nRow, vrRecord);
-
-            if (_this->g_quRecords.count() > 1000)  // TODO const
-            {
-                qint64 _nPos = _this->g_quRecords.dequeue();
-                _this->g_mapRecords.remove(_nPos);
-            }
-        }
+        // Same record as a row of XDisasmView, which keeps the row cache
+        VEIW_RECORD vrRecord = _this->getViewRecord(index.row());
 
         int nColumn = index.column();
 
@@ -170,10 +161,10 @@ QVariant XDisasmModel::data(const QModelIndex &index, int nRole) const {
     return result;
 }
 
-XDisasmModel::VEIW_RECORD XDisasmModel::getViewRecord(int nRow) {
+XDisasmModel::VEIW_RECORD XDisasmModel::getViewRecord(qint64 nPosition) {
     VEIW_RECORD result = {0};
 
-    qint64 nAddress = positionToAddress(nRow);
+    qint64 nAddress = positionToAddress(nPosition);
 
     qint64 nOffset = XBinary::addressToOffset(&(g_pStats->memoryMap), nAddress);
 
@@ -190,16 +181,30 @@ XDisasmModel::VEIW_RECORD XDisasmModel::getViewRecord(int nRow) {
         result.sOffset = XBinary::valueToHex((quint32)nOffset);
     }
 
+    qint64 nReadSize = 1;
+
     if (g_pStats->mapVB.contains(nAddress)) {
-        nSize = g_pStats->mapVB.value(nAddress).nSize;
+        XDisasm::VIEW_BLOCK vb = g_pStats->mapVB.value(nAddress);
+
+        nSize = vb.nSize;
+        nReadSize = nSize;
+
+        // Typed runs can be large, the row only shows their start
+        if ((vb.type == XDisasm::VBT_DATA) && (vb.dataType != XDisasm::DT_ANSISTRING) && (vb.dataType != XDisasm::DT_UNICODESTRING)) {
+            nReadSize = qMin(nSize, (qint64)N_DATA_READSIZE);
+        }
     }
 
     QByteArray baData;
 
     if (nOffset != -1) {
         if (g_pDevice->seek(nOffset)) {
-            baData = g_pDevice->read(nSize);
+            baData = g_pDevice->read(nReadSize);
             result.sBytes = baData.toHex();
+
+            if (nReadSize < nSize) {
+                result.sBytes += "...";
+            }
         }
     } else {
         result.sBytes = QString("byte 0x%1 dup(?)").arg(nSize, 0, 16);
@@ -211,24 +216,16 @@ XDisasmModel::VEIW_RECORD XDisasmModel::getViewRecord(int nRow) {
             g_bDisasmInit = initDisasm();
         }
 
-        result.sOpcode = XDisasm::getDisasmString(g_disasm_handle, nAddress, baData.data(), baData.size());
-
-        if (g_pShowOptions->bShowLabels) {
-            if (g_pStats->mmapRefTo.contains(nAddress)) {
-                QList<qint64> listRefs = g_pStats->mmapRefTo.values(nAddress);
-
-                int nNumberOfRefs = listRefs.count();
-
-                for (int i = 0; i < nNumberOfRefs; i++) {
-                    QString sAddress = QString("0x%1").arg(listRefs.at(i), 0, 16);
-                    QString sRString = g_pStats->mapLabelStrings.value(listRefs.at(i));
-                    result.sOpcode = result.sOpcode.replace(sAddress, sRString);
-                }
-            }
+        if (g_pInsn) {
+            result.sOpcode = XDisasm::getOpcodeString(g_pStats, g_disasm_handle, g_pInsn, nAddress, baData.data(), baData.size(), g_pShowOptions->bShowLabels);
         }
+    } else if (g_pStats->mapVB.value(nAddress).type == XDisasm::VBT_DATA) {
+        XDisasm::VIEW_BLOCK vb = g_pStats->mapVB.value(nAddress);
+
+        result.sOpcode = XDisasm::getDataString(g_pStats, &vb, &baData);
     }
 
-    result.sLabel = g_pStats->mapLabelStrings.value(nAddress);
+    result.sLabel = XDisasm::getLabelString(g_pStats, nAddress);
 
     return result;
 }
@@ -359,21 +356,21 @@ void XDisasmModel::_beginResetModel() {
 }
 
 void XDisasmModel::_endResetModel() {
-    resetCache();
     endResetModel();
 }
 
-void XDisasmModel::resetCache() {
-    g_mapRecords.clear();
-    g_quRecords.clear();
+XDisasmSignatureIndex *XDisasmModel::getSignatureIndex() {
+    return &(g_pStats->signatureIndex);
 }
 
 bool XDisasmModel::initDisasm() {
-    bool bResult = false;
+    // Rows only need mnemonic and operands
+    bool bResult = XDisasmArch::openHandle(g_pStats->csarch, g_pStats->csmode, XDisasmArch::DP_DISPLAY, &g_disasm_handle);
 
-    cs_err err = cs_open(g_pStats->csarch, g_pStats->csmode, &g_disasm_handle);
-    if (!err) {
-        cs_option(g_disasm_handle, CS_OPT_DETAIL, CS_OPT_ON);  // TODO Check
+    if (bResult) {
+        // One instruction buffer is reused for every row
+        g_pInsn = cs_malloc(g_disasm_handle);
+        bResult = (g_pInsn != 0);
     }
 
     return bResult;
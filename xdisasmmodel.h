@@ -22,13 +22,15 @@
 #define XDISASMMODEL_H
 
 #include <QAbstractTableModel>
-#include <QQueue>
+#include <climits>
 
 #include "xdisasm.h"
 
 class XDisasmModel : public QAbstractTableModel {
     Q_OBJECT
 
+    static const int N_DATA_READSIZE = 0x100;
+
 public:
     enum UD {
         UD_ADDRESS = 0,
@@ -65,7 +67,7 @@ public:
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int nRole = Qt::DisplayRole) const override;
-    VEIW_RECORD getViewRecord(int nRow);
+    VEIW_RECORD getViewRecord(qint64 nPosition);
     qint64 getPositionCount() const;
     qint64 positionToAddress(qint64 nPosition);
     qint64 addressToPosition(qint64 nAddress);
@@ -74,17 +76,15 @@ public:
     XDisasm::STATS *getStats();
     void _beginResetModel();
     void _endResetModel();
-    void resetCache();
+    XDisasmSignatureIndex *getSignatureIndex();
     bool initDisasm();
 
 private:
     QIODevice *g_pDevice;
     XDisasm::STATS *g_pStats;
     SHOWOPTIONS *g_pShowOptions;
-
-    QQueue<qint64> g_quRecords;
-    QMap<qint64, VEIW_RECORD> g_mapRecords;
     csh g_disasm_handle;
+    cs_insn *g_pInsn;
     bool g_bDisasmInit;
 };
 
@@ -0,0 +1,485 @@
+// Copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "xdisasmsignature.h"
+
+XDisasmSignature::XDisasmSignature() {
+    g_nMaxSize = 0;
+    g_bIsCompiled = false;
+}
+
+void XDisasmSignature::clear() {
+    g_listSignatures.clear();
+    g_listNext.clear();
+    g_listOutputIndex.clear();
+    g_listOutputs.clear();
+    g_listUnanchored.clear();
+    g_nMaxSize = 0;
+    g_bIsCompiled = false;
+}
+
+bool XDisasmSignature::addSignature(QString sSignature, QString sName) {
+    bool bResult = false;
+
+    SIGNATURE signature = {};
+    signature.sName = sName;
+
+    if (_parse(sSignature, &signature)) {
+        g_listSignatures.append(signature);
+        g_nMaxSize = qMax(g_nMaxSize, signature.nSize);
+        g_bIsCompiled = false;
+
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+qint32 XDisasmSignature::addSignatures(QString sText) {
+    qint32 nResult = 0;
+
+    QStringList listLines = sText.split(QChar('\n'));
+
+    int nNumberOfLines = listLines.count();
+
+    for (int i = 0; i < nNumberOfLines; i++) {
+        QString sLine = listLines.at(i).trimmed();
+
+        if ((sLine != "") && (!sLine.startsWith(QChar(';'))) && (!sLine.startsWith("//"))) {
+            // name: signature
+            QString sName;
+            QString sSignature = sLine;
+
+            int nIndex = sLine.indexOf(QChar(':'));
+
+            if (nIndex != -1) {
+                sName = sLine.left(nIndex).trimmed();
+                sSignature = sLine.mid(nIndex + 1);
+            }
+
+            if (addSignature(sSignature, sName)) {
+                nResult++;
+            }
+        }
+    }
+
+    return nResult;
+}
+
+qint32 XDisasmSignature::getNumberOfSignatures() {
+    return g_listSignatures.count();
+}
+
+void XDisasmSignature::compile() {
+    g_listNext.clear();
+    g_listOutputIndex.clear();
+    g_listOutputs.clear();
+    g_listUnanchored.clear();
+
+    // Aho-Corasick over the anchors, one pass finds every candidate
+    g_listNext.fill(-1, 256);
+
+    QVector<qint32> listFail;
+    listFail.append(0);
+
+    QVector<QVector<qint32>> listStateOutputs;
+    listStateOutputs.append(QVector<qint32>());
+
+    int nNumberOfSignatures = g_listSignatures.count();
+
+    for (int i = 0; i < nNumberOfSignatures; i++) {
+        const SIGNATURE *pSignature = &(g_listSignatures.at(i));
+
+        if (pSignature->nAnchorSize) {
+            const char *pAnchor = pSignature->listFragments.at(0).baValue.constData() + pSignature->nAnchorOffset;
+
+            qint32 nState = 0;
+
+            for (int j = 0; j < pSignature->nAnchorSize; j++) {
+                qint32 nIndex = nState * 256 + (quint8)(pAnchor[j]);
+                qint32 nNext = g_listNext.at(nIndex);
+
+                if (nNext == -1) {
+                    nNext = listFail.count();
+
+                    g_listNext[nIndex] = nNext;
+                    g_listNext.insert(g_listNext.size(), 256, -1);
+                    listFail.append(0);
+                    listStateOutputs.append(QVector<qint32>());
+                }
+
+                nState = nNext;
+            }
+
+            listStateOutputs[nState].append(i);
+        } else {
+            g_listUnanchored.append(i);
+        }
+    }
+
+    QQueue<qint32> quStates;
+
+    for (int i = 0; i < 256; i++) {
+        qint32 nNext = g_listNext.at(i);
+
+        if (nNext == -1) {
+            g_listNext[i] = 0;
+        } else {
+            listFail[nNext] = 0;
+            quStates.enqueue(nNext);
+        }
+    }
+
+    while (!quStates.isEmpty()) {
+        qint32 nState = quStates.dequeue();
+
+        for (int i = 0; i < 256; i++) {
+            qint32 nNext = g_listNext.at(nState * 256 + i);
+            qint32 nFail = g_listNext.at(listFail.at(nState) * 256 + i);
+
+            if (nNext == -1) {
+                g_listNext[nState * 256 + i] = nFail;
+            } else {
+                listFail[nNext] = nFail;
+                listStateOutputs[nNext] += listStateOutputs.at(nFail);
+                quStates.enqueue(nNext);
+            }
+        }
+    }
+
+    int nNumberOfStates = listStateOutputs.count();
+
+    for (int i = 0; i < nNumberOfStates; i++) {
+        g_listOutputIndex.append(g_listOutputs.count());
+        g_listOutputs += listStateOutputs.at(i);
+    }
+
+    g_listOutputIndex.append(g_listOutputs.count());
+
+    g_bIsCompiled = true;
+}
+
+QList<XDisasmSignature::RESULT> XDisasmSignature::scan(QIODevice *pDevice, XBinary::_MEMORY_MAP *pMemoryMap, qint64 nOffset, qint64 nSize, bool *pbStop) {
+    QList<RESULT> listResult;
+
+    if (!g_bIsCompiled) {
+        compile();
+    }
+
+    SCAN_CONTEXT context = {};
+    context.pDevice = pDevice;
+    context.pMemoryMap = pMemoryMap;
+    context.pbStop = pbStop;
+
+    _scan(&context, nOffset, nSize, &listResult);
+
+    return listResult;
+}
+
+QList<XDisasmSignature::RESULT> XDisasmSignature::scan(QIODevice *pDevice, XBinary::_MEMORY_MAP *pMemoryMap, QList<XBinary::_MEMORY_RECORD> *pListRegions,
+                                                       bool *pbStop) {
+    QList<RESULT> listResult;
+
+    if (!g_bIsCompiled) {
+        compile();
+    }
+
+    // Followed branches are shared by every region of the image
+    SCAN_CONTEXT context = {};
+    context.pDevice = pDevice;
+    context.pMemoryMap = pMemoryMap;
+    context.pbStop = pbStop;
+
+    int nNumberOfRegions = pListRegions->count();
+
+    for (int i = 0; (i < nNumberOfRegions) && (!(pbStop && *pbStop)); i++) {
+        _scan(&context, pListRegions->at(i).nOffset, pListRegions->at(i).nSize, &listResult);
+    }
+
+    return listResult;
+}
+
+bool XDisasmSignature::_parse(QString sSignature, SIGNATURE *pSignature) {
+    bool bResult = true;
+
+    QString sText = sSignature;
+    sText.remove(QChar(' '));
+    sText.remove(QChar('\t'));
+    sText.remove(QChar('\r'));
+
+    int nSize = sText.size();
+
+    if ((nSize == 0) || (nSize % 2)) {
+        bResult = false;
+    }
+
+    FRAGMENT fragment = {};
+
+    for (int i = 0; (i < nSize) && bResult; i += 2) {
+        QChar c1 = sText.at(i);
+        QChar c2 = sText.at(i + 1);
+
+        if ((c1 == QChar('$')) || (c2 == QChar('$'))) {
+            if (c1 == c2) {
+                fragment.nRelSize++;
+            } else {
+                bResult = false;
+            }
+        } else {
+            if (fragment.nRelSize) {
+                pSignature->listFragments.append(fragment);
+                fragment = {};
+            }
+
+            quint8 nValue = 0;
+            quint8 nMask = 0;
+
+            // Any other symbol is a wildcard nibble
+            for (int j = 0; j < 2; j++) {
+                char cSymbol = sText.at(i + j).toLatin1();
+                int nDigit = -1;
+
+                if ((cSymbol >= '0') && (cSymbol <= '9')) {
+                    nDigit = cSymbol - '0';
+                } else if ((cSymbol >= 'a') && (cSymbol <= 'f')) {
+                    nDigit = cSymbol - 'a' + 10;
+                } else if ((cSymbol >= 'A') && (cSymbol <= 'F')) {
+                    nDigit = cSymbol - 'A' + 10;
+                }
+
+                nValue <<= 4;
+                nMask <<= 4;
+
+                if (nDigit != -1) {
+                    nValue |= nDigit;
+                    nMask |= 0x0F;
+                }
+            }
+
+            fragment.baValue.append((char)nValue);
+            fragment.baMask.append((char)nMask);
+        }
+    }
+
+    if (bResult) {
+        pSignature->listFragments.append(fragment);
+    }
+
+    int nNumberOfFragments = pSignature->listFragments.count();
+
+    for (int i = 0; (i < nNumberOfFragments) && bResult; i++) {
+        qint32 nRelSize = pSignature->listFragments.at(i).nRelSize;
+
+        if ((nRelSize == 0) || (nRelSize == 1) || (nRelSize == 2) || (nRelSize == 4)) {
+            pSignature->nSize += pSignature->listFragments.at(i).baValue.size() + nRelSize;
+        } else {
+            bResult = false;
+        }
+    }
+
+    if (bResult) {
+        const QByteArray *pMask = &(pSignature->listFragments.at(0).baMask);
+
+        int nFragmentSize = pMask->size();
+        int nRunSize = 0;
+
+        for (int i = 0; i < nFragmentSize; i++) {
+            if ((quint8)(pMask->at(i)) == 0xFF) {
+                nRunSize++;
+
+                if (nRunSize > pSignature->nAnchorSize) {
+                    pSignature->nAnchorOffset = i - nRunSize + 1;
+                    pSignature->nAnchorSize = nRunSize;
+                }
+            } else {
+                nRunSize = 0;
+            }
+        }
+
+        pSignature->nAnchorSize = qMin(pSignature->nAnchorSize, (qint32)N_ANCHOR_SIZE);
+    }
+
+    return bResult;
+}
+
+bool XDisasmSignature::_compare(const FRAGMENT *pFragment, const char *pData) {
+    bool bResult = true;
+
+    const char *pValue = pFragment->baValue.constData();
+    const char *pMask = pFragment->baMask.constData();
+    int nFragmentSize = pFragment->baValue.size();
+
+    for (int i = 0; i < nFragmentSize; i++) {
+        if ((pData[i] & pMask[i]) != pValue[i]) {
+            bResult = false;
+            break;
+        }
+    }
+
+    return bResult;
+}
+
+qint64 XDisasmSignature::_getRelTarget(const FRAGMENT *pFragment, const char *pData, qint64 nAddress) {
+    qint64 nResult = 0;
+
+    const char *pRel = pData + pFragment->baValue.size();
+
+    if (pFragment->nRelSize == 1) {
+        nResult = *((qint8 *)pRel);
+    } else if (pFragment->nRelSize == 2) {
+        nResult = (qint16)(((quint8)pRel[0]) | (((quint8)pRel[1]) << 8));
+    } else if (pFragment->nRelSize == 4) {
+        nResult = (qint32)(((quint32)(quint8)pRel[0]) | (((quint32)(quint8)pRel[1]) << 8) | (((quint32)(quint8)pRel[2]) << 16) |
+                           (((quint32)(quint8)pRel[3]) << 24));
+    }
+
+    // Relative to the end of the placeholder
+    nResult += nAddress + pFragment->baValue.size() + pFragment->nRelSize;
+
+    return nResult;
+}
+
+bool XDisasmSignature::_follow(SCAN_CONTEXT *pContext, qint32 nIndex, qint32 nFragment, qint64 nAddress) {
+    bool bResult = false;
+
+    QPair<qint64, qint64> key(((qint64)nIndex << 16) | nFragment, nAddress);
+
+    if (pContext->mapVisited.contains(key)) {
+        bResult = pContext->mapVisited.value(key);
+    } else {
+        pContext->mapVisited.insert(key, false);
+
+        const FRAGMENT *pFragment = &(g_listSignatures.at(nIndex).listFragments.at(nFragment));
+
+        qint64 nOffset = XBinary::addressToOffset(pContext->pMemoryMap, nAddress);
+        qint32 nSize = pFragment->baValue.size() + pFragment->nRelSize;
+
+        if (nOffset != -1) {
+            const char *pData = nullptr;
+            QByteArray baData;
+
+            if ((nOffset >= pContext->nBufferOffset) && ((nOffset + nSize) <= (pContext->nBufferOffset + pContext->nBufferSize))) {
+                pData = pContext->pBuffer + (nOffset - pContext->nBufferOffset);
+            } else {
+                baData.resize(nSize);
+
+                if (XBinary::read_array(pContext->pDevice, nOffset, baData.data(), nSize) == nSize) {
+                    pData = baData.constData();
+                }
+            }
+
+            if (pData && _compare(pFragment, pData)) {
+                if (pFragment->nRelSize && ((nFragment + 1) < g_listSignatures.at(nIndex).listFragments.count())) {
+                    bResult = _follow(pContext, nIndex, nFragment + 1, _getRelTarget(pFragment, pData, nAddress));
+                } else {
+                    bResult = true;
+                }
+            }
+        }
+
+        pContext->mapVisited.insert(key, bResult);
+    }
+
+    return bResult;
+}
+
+void XDisasmSignature::_scan(SCAN_CONTEXT *pContext, qint64 nOffset, qint64 nSize, QList<RESULT> *pListResults) {
+    QByteArray baBuffer;
+
+    qint64 nEnd = nOffset + nSize;
+    qint32 nState = 0;
+    int nNumberOfUnanchored = g_listUnanchored.count();
+
+    for (qint64 nChunkOffset = nOffset; (nChunkOffset < nEnd) && (!(pContext->pbStop && *(pContext->pbStop))); nChunkOffset += N_BUFFER_SIZE) {
+        qint64 nChunkSize = qMin((qint64)N_BUFFER_SIZE, nEnd - nChunkOffset);
+
+        // Keep the longest signature on both sides so a hit near the border can be verified
+        qint64 nBufferOffset = qMax(nOffset, nChunkOffset - g_nMaxSize);
+        qint64 nBufferSize = qMin(nEnd, nChunkOffset + nChunkSize + g_nMaxSize) - nBufferOffset;
+
+        baBuffer.resize(nBufferSize);
+        nBufferSize = XBinary::read_array(pContext->pDevice, nBufferOffset, baBuffer.data(), nBufferSize);
+
+        if (nBufferSize <= 0) {
+            break;
+        }
+
+        pContext->pBuffer = baBuffer.constData();
+        pContext->nBufferOffset = nBufferOffset;
+        pContext->nBufferSize = nBufferSize;
+
+        qint64 nStart = nChunkOffset - nBufferOffset;
+        qint64 nStop = qMin(nStart + nChunkSize, nBufferSize);
+
+        for (qint64 i = nStart; i < nStop; i++) {
+            nState = g_listNext.at(nState * 256 + (quint8)(pContext->pBuffer[i]));
+
+            qint32 nOutputFrom = g_listOutputIndex.at(nState);
+            qint32 nOutputTo = g_listOutputIndex.at(nState + 1);
+
+            for (qint32 j = nOutputFrom; j < nOutputTo; j++) {
+                qint32 nIndex = g_listOutputs.at(j);
+                const SIGNATURE *pSignature = &(g_listSignatures.at(nIndex));
+
+                _check(pContext, nIndex, i - (pSignature->nAnchorOffset + pSignature->nAnchorSize - 1), pListResults);
+            }
+
+            for (int j = 0; j < nNumberOfUnanchored; j++) {
+                _check(pContext, g_listUnanchored.at(j), i, pListResults);
+            }
+        }
+    }
+
+    pContext->pBuffer = nullptr;
+    pContext->nBufferOffset = 0;
+    pContext->nBufferSize = 0;
+}
+
+void XDisasmSignature::_check(SCAN_CONTEXT *pContext, qint32 nIndex, qint64 nPosition, QList<RESULT> *pListResults) {
+    const SIGNATURE *pSignature = &(g_listSignatures.at(nIndex));
+    const FRAGMENT *pFragment = &(pSignature->listFragments.at(0));
+
+    if ((nPosition >= 0) && ((nPosition + pFragment->baValue.size() + pFragment->nRelSize) <= pContext->nBufferSize)) {
+        const char *pData = pContext->pBuffer + nPosition;
+
+        if (_compare(pFragment, pData)) {
+            qint64 nOffset = pContext->nBufferOffset + nPosition;
+            qint64 nAddress = XBinary::offsetToAddress(pContext->pMemoryMap, nOffset);
+
+            bool bIsValid = true;
+
+            // A trailing placeholder is matched without following it
+            if (pFragment->nRelSize && (pSignature->listFragments.count() > 1)) {
+                // The rest of the signature is where the branch goes
+                bIsValid = (nAddress != -1) && _follow(pContext, nIndex, 1, _getRelTarget(pFragment, pData, nAddress));
+            }
+
+            if (bIsValid) {
+                RESULT record = {};
+                record.nOffset = nOffset;
+                record.nAddress = nAddress;
+                record.nSignatureIndex = nIndex;
+                record.sName = pSignature->sName;
+
+                pListResults->append(record);
+            }
+        }
+    }
+}
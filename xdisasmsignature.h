@@ -0,0 +1,90 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef XDISASMSIGNATURE_H
+#define XDISASMSIGNATURE_H
+
+#include <QQueue>
+
+#include "xformats.h"
+
+class XDisasmSignature {
+    static const int N_ANCHOR_SIZE = 8;
+    static const int N_BUFFER_SIZE = 0x100000;
+
+public:
+    struct RESULT {
+        qint64 nAddress;
+        qint64 nOffset;
+        qint32 nSignatureIndex;
+        QString sName;
+    };
+
+    XDisasmSignature();
+    void clear();
+    bool addSignature(QString sSignature, QString sName = "");
+    qint32 addSignatures(QString sText);
+    qint32 getNumberOfSignatures();
+    void compile();
+    QList<RESULT> scan(QIODevice *pDevice, XBinary::_MEMORY_MAP *pMemoryMap, qint64 nOffset, qint64 nSize, bool *pbStop = nullptr);
+    QList<RESULT> scan(QIODevice *pDevice, XBinary::_MEMORY_MAP *pMemoryMap, QList<XBinary::_MEMORY_RECORD> *pListRegions, bool *pbStop = nullptr);
+
+private:
+    struct FRAGMENT {
+        QByteArray baValue;  // already masked
+        QByteArray baMask;
+        qint32 nRelSize;  // '$' placeholder after the fragment
+    };
+
+    struct SIGNATURE {
+        QString sName;
+        QList<FRAGMENT> listFragments;
+        qint32 nSize;
+        qint32 nAnchorOffset;  // longest literal run of the first fragment
+        qint32 nAnchorSize;
+    };
+
+    struct SCAN_CONTEXT {
+        QIODevice *pDevice;
+        XBinary::_MEMORY_MAP *pMemoryMap;
+        bool *pbStop;
+        const char *pBuffer;
+        qint64 nBufferOffset;
+        qint64 nBufferSize;
+        QHash<QPair<qint64, qint64>, bool> mapVisited;  // (signature, fragment), address
+    };
+
+    static bool _parse(QString sSignature, SIGNATURE *pSignature);
+    static bool _compare(const FRAGMENT *pFragment, const char *pData);
+    static qint64 _getRelTarget(const FRAGMENT *pFragment, const char *pData, qint64 nAddress);
+    bool _follow(SCAN_CONTEXT *pContext, qint32 nIndex, qint32 nFragment, qint64 nAddress);
+    void _scan(SCAN_CONTEXT *pContext, qint64 nOffset, qint64 nSize, QList<RESULT> *pListResults);
+    void _check(SCAN_CONTEXT *pContext, qint32 nIndex, qint64 nPosition, QList<RESULT> *pListResults);
+
+    QList<SIGNATURE> g_listSignatures;
+    QVector<qint32> g_listNext;  // 256 transitions per state, failure links folded in
+    QVector<qint32> g_listOutputIndex;
+    QVector<qint32> g_listOutputs;
+    QVector<qint32> g_listUnanchored;
+    qint32 g_nMaxSize;
+    bool g_bIsCompiled;
+};
+
+#endif  // XDISASMSIGNATURE_H
@@ -0,0 +1,202 @@
+// Copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "xdisasmsignatureindex.h"
+
+XDisasmSignatureIndex::XDisasmSignatureIndex() {
+}
+
+void XDisasmSignatureIndex::clear() {
+    g_baData.clear();
+    g_listSourceEnds.clear();
+    g_listBucketIndex.clear();
+    g_listPositions.clear();
+}
+
+bool XDisasmSignatureIndex::addData(const QByteArray &baData) {
+    bool bResult = false;
+
+    if (baData.size() <= getFreeSize()) {
+        if (baData.size()) {
+            g_baData.append(baData);
+            g_listSourceEnds.append(g_baData.size());
+        }
+
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+void XDisasmSignatureIndex::addRegions(QIODevice *pDevice, QList<XBinary::_MEMORY_RECORD> *pListRegions) {
+    int nNumberOfRegions = pListRegions->count();
+
+    for (int i = 0; (i < nNumberOfRegions) && (pListRegions->at(i).nSize <= getFreeSize()); i++) {
+        QByteArray baData;
+        baData.resize(pListRegions->at(i).nSize);
+
+        qint64 nDataSize = XBinary::read_array(pDevice, pListRegions->at(i).nOffset, baData.data(), baData.size());
+
+        if (nDataSize > 0) {
+            baData.resize(nDataSize);
+
+            addData(baData);
+        }
+    }
+}
+
+void XDisasmSignatureIndex::build() {
+    // Hashed 3-grams in CSR form: bucket -> sorted positions
+    g_listBucketIndex.fill(0, N_NUMBER_OF_BUCKETS + 1);
+    g_listPositions.clear();
+
+    const char *pData = g_baData.constData();
+
+    qint64 nSourceBegin = 0;
+    int nNumberOfSources = g_listSourceEnds.count();
+
+    for (int i = 0; i < nNumberOfSources; i++) {
+        qint64 nSourceEnd = g_listSourceEnds.at(i);
+
+        for (qint64 j = nSourceBegin; (j + N_GRAM_SIZE) <= nSourceEnd; j++) {
+            g_listBucketIndex[_hash(pData + j) + 1]++;
+        }
+
+        nSourceBegin = nSourceEnd;
+    }
+
+    for (int i = 0; i < N_NUMBER_OF_BUCKETS; i++) {
+        g_listBucketIndex[i + 1] += g_listBucketIndex.at(i);
+    }
+
+    g_listPositions.resize(g_listBucketIndex.at(N_NUMBER_OF_BUCKETS));
+
+    QVector<qint32> listFill = g_listBucketIndex;
+
+    nSourceBegin = 0;
+
+    for (int i = 0; i < nNumberOfSources; i++) {
+        qint64 nSourceEnd = g_listSourceEnds.at(i);
+
+        for (qint64 j = nSourceBegin; (j + N_GRAM_SIZE) <= nSourceEnd; j++) {
+            g_listPositions[listFill[_hash(pData + j)]++] = (qint32)j;
+        }
+
+        nSourceBegin = nSourceEnd;
+    }
+}
+
+bool XDisasmSignatureIndex::isEmpty() {
+    return g_listBucketIndex.isEmpty();
+}
+
+qint64 XDisasmSignatureIndex::getFreeSize() {
+    return N_MAX_SIZE - g_baData.size();
+}
+
+qint32 XDisasmSignatureIndex::getCount(const QByteArray &baValue, const QByteArray &baMask, qint32 nLimit) {
+    qint32 nResult = 0;
+
+    qint32 nSize = baValue.size();
+
+    if (nSize && (!isEmpty())) {
+        // The rarest fully specified 3-gram selects the candidates
+        qint32 nGramOffset = -1;
+        qint32 nGramCount = 0;
+
+        for (qint32 i = 0; (i + N_GRAM_SIZE) <= nSize; i++) {
+            bool bIsLiteral = true;
+
+            for (qint32 j = 0; j < N_GRAM_SIZE; j++) {
+                if ((quint8)(baMask.at(i + j)) != 0xFF) {
+                    bIsLiteral = false;
+                    break;
+                }
+            }
+
+            if (bIsLiteral) {
+                quint32 nHash = _hash(baValue.constData() + i);
+                qint32 nCount = g_listBucketIndex.at(nHash + 1) - g_listBucketIndex.at(nHash);
+
+                if ((nGramOffset == -1) || (nCount < nGramCount)) {
+                    nGramOffset = i;
+                    nGramCount = nCount;
+                }
+            }
+        }
+
+        if (nGramOffset != -1) {
+            quint32 nHash = _hash(baValue.constData() + nGramOffset);
+
+            qint32 nFrom = g_listBucketIndex.at(nHash);
+            qint32 nTo = g_listBucketIndex.at(nHash + 1);
+
+            for (qint32 i = nFrom; (i < nTo) && (nResult < nLimit); i++) {
+                if (_compare((qint64)g_listPositions.at(i) - nGramOffset, baValue, baMask)) {
+                    nResult++;
+                }
+            }
+        } else {
+            qint64 nDataSize = g_baData.size();
+
+            for (qint64 i = 0; (i < nDataSize) && (nResult < nLimit); i++) {
+                if (_compare(i, baValue, baMask)) {
+                    nResult++;
+                }
+            }
+        }
+    }
+
+    return nResult;
+}
+
+quint32 XDisasmSignatureIndex::_hash(const char *pData) {
+    quint32 nValue = (((quint32)(quint8)pData[0]) << 16) | (((quint32)(quint8)pData[1]) << 8) | ((quint32)(quint8)pData[2]);
+
+    return ((nValue * 2654435761U) >> 16) & (N_NUMBER_OF_BUCKETS - 1);
+}
+
+bool XDisasmSignatureIndex::_compare(qint64 nPosition, const QByteArray &baValue, const QByteArray &baMask) {
+    bool bResult = false;
+
+    qint32 nSize = baValue.size();
+
+    if (nPosition >= 0) {
+        // A match must not run from one source into the next
+        QVector<qint64>::const_iterator iter = std::upper_bound(g_listSourceEnds.constBegin(), g_listSourceEnds.constEnd(), nPosition);
+
+        if ((iter != g_listSourceEnds.constEnd()) && ((nPosition + nSize) <= *iter)) {
+            const char *pData = g_baData.constData() + nPosition;
+            const char *pValue = baValue.constData();
+            const char *pMask = baMask.constData();
+
+            bResult = true;
+
+            for (qint32 i = 0; i < nSize; i++) {
+                if ((pData[i] & pMask[i]) != pValue[i]) {
+                    bResult = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    return bResult;
+}
@@ -0,0 +1,53 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef XDISASMSIGNATUREINDEX_H
+#define XDISASMSIGNATUREINDEX_H
+
+#include <algorithm>
+
+#include "xformats.h"
+
+class XDisasmSignatureIndex {
+    static const int N_GRAM_SIZE = 3;
+    static const int N_NUMBER_OF_BUCKETS = 0x10000;
+    static const int N_MAX_SIZE = 0x40000000;  // positions are qint32
+
+public:
+    XDisasmSignatureIndex();
+    void clear();
+    bool addData(const QByteArray &baData);
+    void addRegions(QIODevice *pDevice, QList<XBinary::_MEMORY_RECORD> *pListRegions);
+    void build();
+    bool isEmpty();
+    qint64 getFreeSize();
+    qint32 getCount(const QByteArray &baValue, const QByteArray &baMask, qint32 nLimit);
+
+private:
+    static quint32 _hash(const char *pData);
+    bool _compare(qint64 nPosition, const QByteArray &baValue, const QByteArray &baMask);
+
+    QByteArray g_baData;  // all sources back to back
+    QVector<qint64> g_listSourceEnds;
+    QVector<qint32> g_listBucketIndex;
+    QVector<qint32> g_listPositions;
+};
+
+#endif  // XDISASMSIGNATUREINDEX_H
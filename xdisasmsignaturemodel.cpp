@@ -0,0 +1,311 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "xdisasmsignaturemodel.h"
+
+XDisasmSignatureModel::XDisasmSignatureModel(XBinary::MODE mode, QObject *pParent) : QAbstractTableModel(pParent) {
+    this->g_mode = mode;
+}
+
+QVariant XDisasmSignatureModel::headerData(int section, Qt::Orientation orientation, int nRole) const {
+    QVariant result;
+
+    if (orientation == Qt::Horizontal) {
+        if (nRole == Qt::DisplayRole) {
+            switch (section) {
+                case SMCOLUMN_ADDRESS:
+                    result = tr("Address");
+                    break;
+                case SMCOLUMN_BYTES:
+                    result = tr("Bytes");
+                    break;
+                case SMCOLUMN_OPCODE:
+                    result = tr("Opcode");
+                    break;
+            }
+        }
+    }
+
+    return result;
+}
+
+int XDisasmSignatureModel::rowCount(const QModelIndex &parent) const {
+    int nResult = g_listRecords.count();
+
+    if (parent.isValid()) {
+        nResult = 0;
+    }
+
+    return nResult;
+}
+
+int XDisasmSignatureModel::columnCount(const QModelIndex &parent) const {
+    int nResult = __SMCOLUMN_SIZE;
+
+    if (parent.isValid()) {
+        nResult = 0;
+    }
+
+    return nResult;
+}
+
+QVariant XDisasmSignatureModel::data(const QModelIndex &index, int nRole) const {
+    QVariant result;
+
+    if (index.isValid()) {
+        int nRow = index.row();
+        int nColumn = index.column();
+
+        const XDisasm::SIGNATURE_RECORD *pRecord = &(g_listRecords.at(nRow));
+
+        if (nRole == Qt::DisplayRole) {
+            if (nColumn == SMCOLUMN_ADDRESS) {
+                result = XBinary::valueToHex(g_mode, pRecord->nAddress);
+            } else if (nColumn == SMCOLUMN_BYTES) {
+                result = QString(pRecord->baOpcode.toHex().data());
+            } else if (nColumn == SMCOLUMN_OPCODE) {
+                result = pRecord->sOpcode;
+            } else if ((nColumn == SMCOLUMN_DISP) && isCheckable(nRow, nColumn)) {
+                result = QString("d");
+            } else if ((nColumn == SMCOLUMN_IMM) && isCheckable(nRow, nColumn)) {
+                result = QString("i");
+            }
+        } else if (nRole == Qt::CheckStateRole) {
+            if (isCheckable(nRow, nColumn)) {
+                result = isChecked(nRow, nColumn) ? Qt::Checked : Qt::Unchecked;
+            }
+        }
+    }
+
+    return result;
+}
+
+bool XDisasmSignatureModel::setData(const QModelIndex &index, const QVariant &value, int nRole) {
+    bool bResult = false;
+
+    if (index.isValid() && (nRole == Qt::CheckStateRole)) {
+        int nRow = index.row();
+        int nColumn = index.column();
+
+        if (isCheckable(nRow, nColumn)) {
+            g_baMask.setBit(nRow * 3 + (nColumn - SMCOLUMN_OPCODE), value.toInt() != Qt::Checked);
+
+            if (nColumn == SMCOLUMN_OPCODE) {
+                // disp and imm are enabled only for a used opcode
+                emit dataChanged(this->index(nRow, SMCOLUMN_OPCODE), this->index(nRow, SMCOLUMN_IMM));
+            } else {
+                emit dataChanged(index, index);
+            }
+
+            emit maskChanged();
+
+            bResult = true;
+        }
+    }
+
+    return bResult;
+}
+
+Qt::ItemFlags XDisasmSignatureModel::flags(const QModelIndex &index) const {
+    Qt::ItemFlags result = QAbstractTableModel::flags(index);
+
+    if (index.isValid()) {
+        int nRow = index.row();
+        int nColumn = index.column();
+
+        if (isCheckable(nRow, nColumn)) {
+            result |= Qt::ItemIsUserCheckable;
+
+            if ((nColumn != SMCOLUMN_OPCODE) && (!isChecked(nRow, SMCOLUMN_OPCODE))) {
+                result &= ~Qt::ItemIsEnabled;
+            }
+        }
+    }
+
+    return result;
+}
+
+void XDisasmSignatureModel::clear() {
+    beginResetModel();
+
+    g_listRecords.clear();
+    g_baMask.clear();
+
+    endResetModel();
+}
+
+void XDisasmSignatureModel::truncate(int nCount) {
+    int nNumberOfRecords = g_listRecords.count();
+
+    if (nCount < nNumberOfRecords) {
+        beginRemoveRows(QModelIndex(), nCount, nNumberOfRecords - 1);
+
+        g_listRecords.erase(g_listRecords.begin() + nCount, g_listRecords.end());
+        g_baMask.resize(nCount * 3);
+
+        endRemoveRows();
+    }
+}
+
+bool XDisasmSignatureModel::extend(XDisasm::SIGNATURE_OPTIONS *pSignatureOptions, csh disasm_handle, cs_insn *pInsn, XDisasmArch::FLOW_TABLE *pFlowTable,
+                                   qint64 nAddress) {
+    QList<XDisasm::SIGNATURE_RECORD> listRecords = g_listRecords;
+
+    bool bResult = XDisasm::appendSignature(pSignatureOptions, disasm_handle, pInsn, pFlowTable, &listRecords, nAddress);
+
+    int nNumberOfRecords = g_listRecords.count();
+    int _nNumberOfRecords = listRecords.count();
+
+    if (_nNumberOfRecords > nNumberOfRecords) {
+        beginInsertRows(QModelIndex(), nNumberOfRecords, _nNumberOfRecords - 1);
+
+        g_listRecords = listRecords;
+        g_baMask.resize(_nNumberOfRecords * 3);  // new bits are false: nothing is masked
+
+        endInsertRows();
+    }
+
+    return bResult;
+}
+
+QList<XDisasm::SIGNATURE_RECORD> *XDisasmSignatureModel::getRecords() {
+    return &g_listRecords;
+}
+
+QString XDisasmSignatureModel::getSignature(QChar cWild, bool bUpper, bool bSpaces) {
+    QString sResult;
+
+    const char *pszHex = bUpper ? "0123456789ABCDEF" : "0123456789abcdef";
+
+    int nNumberOfRecords = g_listRecords.count();
+
+    for (int i = 0; i < nNumberOfRecords; i++) {
+        const XDisasm::SIGNATURE_RECORD *pRecord = &(g_listRecords.at(i));
+
+        bool bUse = isChecked(i, SMCOLUMN_OPCODE);
+        bool bDisp = isChecked(i, SMCOLUMN_DISP);
+        bool bImm = isChecked(i, SMCOLUMN_IMM);
+
+        const char *pData = pRecord->baOpcode.constData();
+        int nSize = pRecord->baOpcode.size();
+
+        for (int j = 0; j < nSize; j++) {
+            QChar cSymbol;
+
+            ST st = _getSymbolType(pRecord, bUse, bDisp, bImm, j);
+
+            if (st == ST_WILD) {
+                cSymbol = cWild;
+            } else if (st == ST_REL) {
+                cSymbol = QChar('$');
+            }
+
+            if ((!sResult.isEmpty()) && bSpaces) {
+                sResult += QChar(' ');
+            }
+
+            if (cSymbol.isNull()) {
+                sResult += QChar(pszHex[((quint8)pData[j]) >> 4]);
+                sResult += QChar(pszHex[((quint8)pData[j]) & 0x0F]);
+            } else {
+                sResult += cSymbol;
+                sResult += cSymbol;
+            }
+        }
+    }
+
+    return sResult;
+}
+
+void XDisasmSignatureModel::getPattern(QByteArray *pbaValue, QByteArray *pbaMask, QList<qint32> *pListRecordEnds) {
+    int nNumberOfRecords = g_listRecords.count();
+
+    // A followed branch leaves the contiguous bytes, so the pattern stops after it
+    for (int i = 0; i < nNumberOfRecords; i++) {
+        const XDisasm::SIGNATURE_RECORD *pRecord = &(g_listRecords.at(i));
+
+        bool bUse = isChecked(i, SMCOLUMN_OPCODE);
+        bool bDisp = isChecked(i, SMCOLUMN_DISP);
+        bool bImm = isChecked(i, SMCOLUMN_IMM);
+
+        const char *pData = pRecord->baOpcode.constData();
+        int nSize = pRecord->baOpcode.size();
+
+        for (int j = 0; j < nSize; j++) {
+            if (_getSymbolType(pRecord, bUse, bDisp, bImm, j) == ST_BYTE) {
+                pbaValue->append(pData[j]);
+                pbaMask->append((char)0xFF);
+            } else {
+                pbaValue->append((char)0);
+                pbaMask->append((char)0);
+            }
+        }
+
+        pListRecordEnds->append(pbaValue->size());
+
+        if (pRecord->bIsConst) {
+            break;
+        }
+    }
+}
+
+XDisasmSignatureModel::ST XDisasmSignatureModel::_getSymbolType(const XDisasm::SIGNATURE_RECORD *pRecord, bool bUse, bool bDisp, bool bImm, int nIndex) {
+    ST result = ST_BYTE;
+
+    if (!bUse) {
+        result = ST_WILD;
+    } else if (pRecord->bIsConst && pRecord->nImmSize && (nIndex >= pRecord->nImmOffset) && (nIndex < (pRecord->nImmOffset + pRecord->nImmSize))) {
+        result = ST_REL;
+    } else if ((!bDisp) && (nIndex >= pRecord->nDispOffset) && (nIndex < (pRecord->nDispOffset + pRecord->nDispSize))) {
+        result = ST_WILD;
+    } else if ((!bImm) && (nIndex >= pRecord->nImmOffset) && (nIndex < (pRecord->nImmOffset + pRecord->nImmSize))) {
+        result = ST_WILD;
+    }
+
+    return result;
+}
+
+bool XDisasmSignatureModel::isChecked(int nRow, int nColumn) const {
+    bool bResult = true;
+
+    if ((nColumn >= SMCOLUMN_OPCODE) && (nColumn <= SMCOLUMN_IMM)) {
+        bResult = !(g_baMask.testBit(nRow * 3 + (nColumn - SMCOLUMN_OPCODE)));
+    }
+
+    return bResult;
+}
+
+bool XDisasmSignatureModel::isCheckable(int nRow, int nColumn) const {
+    bool bResult = false;
+
+    const XDisasm::SIGNATURE_RECORD *pRecord = &(g_listRecords.at(nRow));
+
+    if (!pRecord->bIsConst) {
+        if (nColumn == SMCOLUMN_OPCODE) {
+            bResult = true;
+        } else if (nColumn == SMCOLUMN_DISP) {
+            bResult = (pRecord->nDispSize != 0);
+        } else if (nColumn == SMCOLUMN_IMM) {
+            bResult = (pRecord->nImmSize != 0);
+        }
+    }
+
+    return bResult;
+}
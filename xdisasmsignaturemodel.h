@@ -0,0 +1,77 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef XDISASMSIGNATUREMODEL_H
+#define XDISASMSIGNATUREMODEL_H
+
+#include <QAbstractTableModel>
+#include <QBitArray>
+
+#include "xdisasm.h"
+
+class XDisasmSignatureModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum SMCOLUMN {
+        SMCOLUMN_ADDRESS = 0,
+        SMCOLUMN_BYTES,
+        SMCOLUMN_OPCODE,
+        SMCOLUMN_DISP,
+        SMCOLUMN_IMM,
+        __SMCOLUMN_SIZE
+    };
+
+    explicit XDisasmSignatureModel(XBinary::MODE mode, QObject *pParent);
+    // Header:
+    QVariant headerData(int section, Qt::Orientation orientation, int nRole = Qt::DisplayRole) const override;
+    // Basic functionality:
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int nRole = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int nRole = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    void clear();
+    void truncate(int nCount);
+    bool extend(XDisasm::SIGNATURE_OPTIONS *pSignatureOptions, csh disasm_handle, cs_insn *pInsn, XDisasmArch::FLOW_TABLE *pFlowTable, qint64 nAddress);
+    QList<XDisasm::SIGNATURE_RECORD> *getRecords();
+    QString getSignature(QChar cWild, bool bUpper, bool bSpaces);
+    void getPattern(QByteArray *pbaValue, QByteArray *pbaMask, QList<qint32> *pListRecordEnds);
+
+signals:
+    void maskChanged();
+
+private:
+    enum ST {
+        ST_BYTE = 0,
+        ST_WILD,
+        ST_REL
+    };
+
+    static ST _getSymbolType(const XDisasm::SIGNATURE_RECORD *pRecord, bool bUse, bool bDisp, bool bImm, int nIndex);
+    bool isChecked(int nRow, int nColumn) const;
+    bool isCheckable(int nRow, int nColumn) const;
+
+    XBinary::MODE g_mode;
+    QList<XDisasm::SIGNATURE_RECORD> g_listRecords;
+    QBitArray g_baMask;  // 3 bits per record: wildcard opcode, disp, imm
+};
+
+#endif  // XDISASMSIGNATUREMODEL_H
@@ -0,0 +1,596 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "xdisasmview.h"
+
+XDisasmView::XDisasmView(QWidget *pParent) : QAbstractScrollArea(pParent) {
+    g_pModel = nullptr;
+    g_nCharWidth = 1;
+    g_nLineHeight = 1;
+    g_nBaseline = 0;
+    g_nSelectionAnchor = -1;
+    g_nSelectionCursor = -1;
+    g_nFirstPosition = 0;
+    g_nScrollShift = 0;
+
+    setFocusPolicy(Qt::StrongFocus);
+
+    _updateMetrics();
+
+    const qint32 listWidths[N_NUMBER_OF_COLUMNS] = {14, 8, 12, 20, 40};
+
+    for (int i = 0; i < N_NUMBER_OF_COLUMNS; i++) {
+        g_listColumnWidths[i] = listWidths[i] * g_nCharWidth;
+    }
+}
+
+void XDisasmView::setModel(XDisasmModel *pModel) {
+    g_pModel = pModel;
+    g_nSelectionAnchor = -1;
+    g_nSelectionCursor = -1;
+
+    reload();
+
+    _setFirstPosition(0);
+}
+
+XDisasmModel *XDisasmView::getModel() {
+    return g_pModel;
+}
+
+void XDisasmView::reload() {
+    g_mapRows.clear();
+
+    _updateScrollBars();
+
+    if (g_pModel) {
+        qint64 nNumberOfPositions = g_pModel->getPositionCount();
+
+        if (g_nSelectionAnchor >= nNumberOfPositions) {
+            g_nSelectionAnchor = -1;
+            g_nSelectionCursor = -1;
+        } else if (g_nSelectionCursor >= nNumberOfPositions) {
+            g_nSelectionCursor = nNumberOfPositions - 1;
+        }
+    }
+
+    viewport()->update();
+}
+
+void XDisasmView::setColumnWidth(int nColumn, int nWidth) {
+    if ((nColumn >= 0) && (nColumn < N_NUMBER_OF_COLUMNS)) {
+        g_listColumnWidths[nColumn] = nWidth;
+
+        _updateScrollBars();
+
+        viewport()->update();
+    }
+}
+
+void XDisasmView::goToPosition(qint64 nPosition) {
+    if (g_pModel) {
+        nPosition = qBound((qint64)0, nPosition, g_pModel->getPositionCount() - 1);
+
+        _setFirstPosition(nPosition);
+
+        _select(nPosition, false);
+    }
+}
+
+qint64 XDisasmView::getSelectionStart() {
+    qint64 nResult = -1;
+
+    if (g_nSelectionAnchor != -1) {
+        nResult = qMin(g_nSelectionAnchor, g_nSelectionCursor);
+    }
+
+    return nResult;
+}
+
+qint64 XDisasmView::getSelectionCount() {
+    qint64 nResult = 0;
+
+    if (g_nSelectionAnchor != -1) {
+        nResult = qAbs(g_nSelectionCursor - g_nSelectionAnchor) + 1;
+    }
+
+    return nResult;
+}
+
+QVector<XDisasmView::TOKEN> XDisasmView::getTokens(QString sText) {
+    QVector<TOKEN> listResult;
+
+    qint32 nSize = sText.size();
+    bool bIsFirst = true;
+
+    for (qint32 i = 0; i < nSize;) {
+        QChar cChar = sText.at(i);
+
+        if ((cChar == QChar('\'')) || (cChar == QChar('"'))) {
+            // Quoted strings of data rows keep the default colour
+            i++;
+
+            while ((i < nSize) && (sText.at(i) != cChar)) {
+                i++;
+            }
+
+            i++;
+        } else if (cChar.isLetterOrNumber() || (cChar == QChar('_')) || (cChar == QChar('.'))) {
+            TOKEN token = {};
+            token.nStart = i;
+            token.type = TT_TEXT;
+
+            bool bIsLabel = false;
+
+            while ((i < nSize) && (sText.at(i).isLetterOrNumber() || (sText.at(i) == QChar('_')) || (sText.at(i) == QChar('.')))) {
+                bIsLabel |= (sText.at(i) == QChar('_'));
+                i++;
+            }
+
+            token.nSize = i - token.nStart;
+
+            if (bIsFirst) {
+                token.type = TT_MNEMONIC;
+            } else if (cChar.isDigit()) {
+                token.type = TT_NUMBER;
+            } else if (bIsLabel) {
+                // Generated label names are the only operands with an underscore
+                token.type = TT_LABEL;
+            }
+
+            if (token.type != TT_TEXT) {
+                listResult.append(token);
+            }
+
+            bIsFirst = false;
+        } else {
+            i++;
+        }
+    }
+
+    return listResult;
+}
+
+void XDisasmView::paintEvent(QPaintEvent *pEvent) {
+    Q_UNUSED(pEvent)
+
+    QPainter painter(viewport());
+
+    qint32 nViewportWidth = viewport()->width();
+    qint32 nViewportHeight = viewport()->height();
+
+    painter.fillRect(viewport()->rect(), palette().color(QPalette::Base));
+
+    if (g_pModel) {
+        qint64 nFirstPosition = g_nFirstPosition;
+        qint64 nNumberOfPositions = g_pModel->getPositionCount();
+        qint64 nSelectionStart = getSelectionStart();
+        qint64 nSelectionEnd = nSelectionStart + getSelectionCount();
+        qint32 nOffsetX = -horizontalScrollBar()->value();
+
+        // Line 0 is the header, a partly visible last line is drawn too
+        qint32 nNumberOfLines = (nViewportHeight + g_nLineHeight - 1) / g_nLineHeight;
+
+        for (qint32 i = 1; (i < nNumberOfLines) && ((nFirstPosition + i - 1) < nNumberOfPositions); i++) {
+            qint64 nPosition = nFirstPosition + i - 1;
+            qint32 nY = i * g_nLineHeight;
+
+            bool bIsSelected = (nPosition >= nSelectionStart) && (nPosition < nSelectionEnd);
+
+            if (bIsSelected) {
+                painter.fillRect(QRect(0, nY, nViewportWidth, g_nLineHeight), palette().color(QPalette::Highlight));
+            }
+
+            ROW row = _getRow(nPosition);
+
+            QColor colorText = bIsSelected ? palette().color(QPalette::HighlightedText) : palette().color(QPalette::Text);
+            QColor colorLabel = bIsSelected ? colorText : _getColor(TT_LABEL);
+
+            qint32 nX = nOffsetX;
+
+            _drawText(&painter, nX, nY, g_listColumnWidths[XDisasmModel::DMCOLUMN_ADDRESS], row.record.sAddress, colorText);
+            nX += g_listColumnWidths[XDisasmModel::DMCOLUMN_ADDRESS];
+
+            _drawText(&painter, nX, nY, g_listColumnWidths[XDisasmModel::DMCOLUMN_OFFSET], row.record.sOffset, colorText);
+            nX += g_listColumnWidths[XDisasmModel::DMCOLUMN_OFFSET];
+
+            _drawText(&painter, nX, nY, g_listColumnWidths[XDisasmModel::DMCOLUMN_LABEL], row.record.sLabel, colorLabel);
+            nX += g_listColumnWidths[XDisasmModel::DMCOLUMN_LABEL];
+
+            _drawText(&painter, nX, nY, g_listColumnWidths[XDisasmModel::DMCOLUMN_BYTES], row.record.sBytes, colorText);
+            nX += g_listColumnWidths[XDisasmModel::DMCOLUMN_BYTES];
+
+            // The last column takes the rest of the line
+            qint32 nLastWidth = qMax(g_listColumnWidths[XDisasmModel::DMCOLUMN_OPCODE], nViewportWidth - nX);
+
+            _drawText(&painter, nX, nY, nLastWidth, row.record.sOpcode, colorText, bIsSelected ? nullptr : &(row.listTokens));
+        }
+
+        _trimRows(nFirstPosition, nNumberOfLines);
+
+        painter.fillRect(QRect(0, 0, nViewportWidth, g_nLineHeight), palette().color(QPalette::Button));
+
+        qint32 nX = nOffsetX;
+
+        for (int i = 0; i < N_NUMBER_OF_COLUMNS; i++) {
+            _drawText(&painter, nX, 0, g_listColumnWidths[i], g_pModel->headerData(i, Qt::Horizontal).toString(), palette().color(QPalette::ButtonText));
+
+            nX += g_listColumnWidths[i];
+
+            painter.setPen(palette().color(QPalette::Mid));
+            painter.drawLine(nX - 1, 0, nX - 1, g_nLineHeight - 1);
+        }
+    }
+}
+
+void XDisasmView::resizeEvent(QResizeEvent *pEvent) {
+    QAbstractScrollArea::resizeEvent(pEvent);
+
+    _updateScrollBars();
+}
+
+void XDisasmView::changeEvent(QEvent *pEvent) {
+    QAbstractScrollArea::changeEvent(pEvent);
+
+    if (pEvent->type() == QEvent::FontChange) {
+        _updateMetrics();
+    } else if (pEvent->type() == QEvent::PaletteChange) {
+        g_mapAtlases.clear();
+    }
+}
+
+void XDisasmView::mousePressEvent(QMouseEvent *pEvent) {
+    if (g_pModel) {
+        qint64 nPosition = _getPositionAt(pEvent->pos());
+
+        if (nPosition != -1) {
+            if (pEvent->button() == Qt::RightButton) {
+                // The context menu works on the selection it was opened on
+                qint64 nSelectionStart = getSelectionStart();
+
+                if ((nPosition < nSelectionStart) || (nPosition >= (nSelectionStart + getSelectionCount()))) {
+                    _select(nPosition, false);
+                }
+            } else if (pEvent->button() == Qt::LeftButton) {
+                _select(nPosition, pEvent->modifiers() & Qt::ShiftModifier);
+            }
+        }
+    }
+
+    QAbstractScrollArea::mousePressEvent(pEvent);
+}
+
+void XDisasmView::mouseMoveEvent(QMouseEvent *pEvent) {
+    if (g_pModel && (pEvent->buttons() & Qt::LeftButton) && (g_nSelectionAnchor != -1)) {
+        qint64 nFirstPosition = g_nFirstPosition;
+        qint64 nPosition = nFirstPosition + (pEvent->pos().y() / g_nLineHeight) - 1;
+
+        if (pEvent->pos().y() < g_nLineHeight) {
+            nPosition = nFirstPosition - 1;
+        }
+
+        nPosition = qBound((qint64)0, nPosition, g_pModel->getPositionCount() - 1);
+
+        _select(nPosition, true);
+        _ensureVisible(nPosition);
+    }
+
+    QAbstractScrollArea::mouseMoveEvent(pEvent);
+}
+
+void XDisasmView::keyPressEvent(QKeyEvent *pEvent) {
+    bool bIsKnown = false;
+
+    if (g_pModel && g_pModel->getPositionCount()) {
+        qint64 nPosition = g_nSelectionCursor;
+
+        if (nPosition == -1) {
+            nPosition = g_nFirstPosition;
+        }
+
+        qint32 nPageSize = _getNumberOfVisibleLines();
+        bIsKnown = true;
+
+        switch (pEvent->key()) {
+            case Qt::Key_Up:
+                nPosition--;
+                break;
+            case Qt::Key_Down:
+                nPosition++;
+                break;
+            case Qt::Key_PageUp:
+                nPosition -= nPageSize;
+                _setFirstPosition(g_nFirstPosition - nPageSize);
+                break;
+            case Qt::Key_PageDown:
+                nPosition += nPageSize;
+                _setFirstPosition(g_nFirstPosition + nPageSize);
+                break;
+            case Qt::Key_Home:
+                nPosition = 0;
+                break;
+            case Qt::Key_End:
+                nPosition = g_pModel->getPositionCount() - 1;
+                break;
+            default:
+                bIsKnown = false;
+        }
+
+        if (bIsKnown) {
+            nPosition = qBound((qint64)0, nPosition, g_pModel->getPositionCount() - 1);
+
+            _select(nPosition, pEvent->modifiers() & Qt::ShiftModifier);
+            _ensureVisible(nPosition);
+        }
+    }
+
+    if (!bIsKnown) {
+        QAbstractScrollArea::keyPressEvent(pEvent);
+    }
+}
+
+void XDisasmView::scrollContentsBy(int dx, int dy) {
+    Q_UNUSED(dx)
+    Q_UNUSED(dy)
+
+    // Only a move of the scroll bar itself changes the top row, a scaled value would round it
+    if ((g_nFirstPosition >> g_nScrollShift) != verticalScrollBar()->value()) {
+        g_nFirstPosition = (qint64)verticalScrollBar()->value() << g_nScrollShift;
+    }
+
+    viewport()->update();
+}
+
+void XDisasmView::_updateMetrics() {
+    QFontMetrics fm(font());
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+    g_nCharWidth = qMax(1, fm.horizontalAdvance(QChar('W')));
+#else
+    g_nCharWidth = qMax(1, fm.width(QChar('W')));
+#endif
+    g_nLineHeight = fm.height() + 4;
+    g_nBaseline = 2 + fm.ascent();
+
+    g_mapAtlases.clear();
+
+    _updateScrollBars();
+
+    viewport()->update();
+}
+
+void XDisasmView::_updateScrollBars() {
+    qint64 nNumberOfPositions = 0;
+
+    if (g_pModel) {
+        nNumberOfPositions = g_pModel->getPositionCount();
+    }
+
+    qint32 nNumberOfLines = _getNumberOfVisibleLines();
+    qint64 nMaxPosition = qMax((qint64)0, nNumberOfPositions - nNumberOfLines);
+    qint64 nFirstPosition = g_nFirstPosition;
+
+    // One scroll step is one position, so scrolling never has to lay out what it skips.
+    // Past INT_MAX positions a step covers a power of two of them.
+    g_nScrollShift = 0;
+
+    while ((nMaxPosition >> g_nScrollShift) > INT_MAX) {
+        g_nScrollShift++;
+    }
+
+    verticalScrollBar()->setRange(0, (int)(nMaxPosition >> g_nScrollShift));
+    verticalScrollBar()->setPageStep(qMax(1, nNumberOfLines >> g_nScrollShift));
+    verticalScrollBar()->setSingleStep(1);
+
+    _setFirstPosition(nFirstPosition);
+
+    qint32 nTotalWidth = 0;
+
+    for (int i = 0; i < N_NUMBER_OF_COLUMNS; i++) {
+        nTotalWidth += g_listColumnWidths[i];
+    }
+
+    horizontalScrollBar()->setRange(0, qMax(0, nTotalWidth - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(g_nCharWidth);
+}
+
+qint32 XDisasmView::_getNumberOfVisibleLines() {
+    return qMax(1, (viewport()->height() / g_nLineHeight) - 1);
+}
+
+qint64 XDisasmView::_getPositionAt(QPoint point) {
+    qint64 nResult = -1;
+
+    qint32 nLine = point.y() / g_nLineHeight;
+
+    if (g_pModel && (nLine > 0)) {
+        qint64 nPosition = g_nFirstPosition + nLine - 1;
+
+        if (nPosition < g_pModel->getPositionCount()) {
+            nResult = nPosition;
+        }
+    }
+
+    return nResult;
+}
+
+void XDisasmView::_select(qint64 nPosition, bool bExtend) {
+    if ((!bExtend) || (g_nSelectionAnchor == -1)) {
+        g_nSelectionAnchor = nPosition;
+    }
+
+    g_nSelectionCursor = nPosition;
+
+    viewport()->update();
+}
+
+void XDisasmView::_ensureVisible(qint64 nPosition) {
+    qint64 nFirstPosition = g_nFirstPosition;
+    qint32 nNumberOfLines = _getNumberOfVisibleLines();
+
+    if (nPosition < nFirstPosition) {
+        _setFirstPosition(nPosition);
+    } else if (nPosition >= (nFirstPosition + nNumberOfLines)) {
+        _setFirstPosition(nPosition - nNumberOfLines + 1);
+    }
+}
+
+void XDisasmView::_setFirstPosition(qint64 nPosition) {
+    qint64 nMaxPosition = 0;
+
+    if (g_pModel) {
+        nMaxPosition = qMax((qint64)0, g_pModel->getPositionCount() - _getNumberOfVisibleLines());
+    }
+
+    g_nFirstPosition = qBound((qint64)0, nPosition, nMaxPosition);
+
+    verticalScrollBar()->setValue((int)(g_nFirstPosition >> g_nScrollShift));
+
+    viewport()->update();
+}
+
+XDisasmView::ROW XDisasmView::_getRow(qint64 nPosition) {
+    ROW result = {};
+
+    QHash<qint64, ROW>::const_iterator iter = g_mapRows.constFind(nPosition);
+
+    if (iter != g_mapRows.constEnd()) {
+        result = iter.value();
+    } else {
+        // One record per line; tokens are found once, not per paint
+        result.record = g_pModel->getViewRecord(nPosition);
+        result.listTokens = getTokens(result.record.sOpcode);
+
+        g_mapRows.insert(nPosition, result);
+    }
+
+    return result;
+}
+
+void XDisasmView::_trimRows(qint64 nFirstPosition, qint32 nNumberOfLines) {
+    if (g_mapRows.count() > (nNumberOfLines * N_CACHE_PAGES)) {
+        qint64 nLow = nFirstPosition - nNumberOfLines * (N_CACHE_PAGES / 2);
+        qint64 nHigh = nFirstPosition + nNumberOfLines * (N_CACHE_PAGES / 2 + 1);
+
+        QMutableHashIterator<qint64, ROW> iRows(g_mapRows);
+        while (iRows.hasNext()) {
+            iRows.next();
+
+            if ((iRows.key() < nLow) || (iRows.key() >= nHigh)) {
+                iRows.remove();
+            }
+        }
+    }
+}
+
+const QPixmap *XDisasmView::_getAtlas(QColor color) {
+    QHash<QRgb, QPixmap>::const_iterator iter = g_mapAtlases.constFind(color.rgba());
+
+    if (iter == g_mapAtlases.constEnd()) {
+        qreal dRatio = devicePixelRatioF();
+        qint32 nNumberOfGlyphs = N_ATLAS_LAST - N_ATLAS_FIRST + 1;
+
+        QPixmap pixmap(qCeil(nNumberOfGlyphs * g_nCharWidth * dRatio), qCeil(g_nLineHeight * dRatio));
+        pixmap.setDevicePixelRatio(dRatio);
+        pixmap.fill(Qt::transparent);
+
+        QPainter painter(&pixmap);
+        painter.setFont(font());
+        painter.setPen(color);
+
+        for (qint32 i = 0; i < nNumberOfGlyphs; i++) {
+            painter.drawText(i * g_nCharWidth, g_nBaseline, QString(QChar(N_ATLAS_FIRST + i)));
+        }
+
+        painter.end();
+
+        iter = g_mapAtlases.insert(color.rgba(), pixmap);
+    }
+
+    return &(iter.value());
+}
+
+void XDisasmView::_drawText(QPainter *pPainter, qint32 nX, qint32 nY, qint32 nWidth, const QString &sText, QColor color, const QVector<XDisasmView::TOKEN> *pListTokens) {
+    qint32 nViewportWidth = viewport()->width();
+    qint32 nNumberOfChars = qMin(sText.size(), (nWidth - g_nCharWidth) / g_nCharWidth);
+    qint32 nNumberOfTokens = pListTokens ? pListTokens->count() : 0;
+    qreal dRatio = devicePixelRatioF();
+
+    // Half a character of padding on the left of every column
+    nX += g_nCharWidth / 2;
+
+    const QPixmap *pAtlas = nullptr;
+    QColor colorCurrent;
+
+    for (qint32 i = 0, j = 0; i < nNumberOfChars; i++) {
+        qint32 nCharX = nX + i * g_nCharWidth;
+
+        if (nCharX >= nViewportWidth) {
+            break;
+        }
+
+        ushort nChar = sText.at(i).unicode();
+
+        if ((nCharX + g_nCharWidth <= 0) || (nChar == ' ')) {
+            continue;
+        }
+
+        QColor colorChar = color;
+
+        if (nNumberOfTokens) {
+            while ((j < nNumberOfTokens) && ((pListTokens->at(j).nStart + pListTokens->at(j).nSize) <= i)) {
+                j++;
+            }
+
+            if ((j < nNumberOfTokens) && (pListTokens->at(j).nStart <= i)) {
+                colorChar = _getColor(pListTokens->at(j).type);
+            }
+        }
+
+        if ((nChar >= N_ATLAS_FIRST) && (nChar <= N_ATLAS_LAST)) {
+            if ((pAtlas == nullptr) || (colorChar != colorCurrent)) {
+                pAtlas = _getAtlas(colorChar);
+                colorCurrent = colorChar;
+            }
+
+            QRectF rectSource((nChar - N_ATLAS_FIRST) * g_nCharWidth * dRatio, 0, g_nCharWidth * dRatio, g_nLineHeight * dRatio);
+
+            pPainter->drawPixmap(QRectF(nCharX, nY, g_nCharWidth, g_nLineHeight), *pAtlas, rectSource);
+        } else {
+            pPainter->setPen(colorChar);
+            pPainter->drawText(nCharX, nY + g_nBaseline, QString(sText.at(i)));
+        }
+    }
+}
+
+QColor XDisasmView::_getColor(XDisasmView::TT type) {
+    QColor result = palette().color(QPalette::Text);
+
+    if (type == TT_MNEMONIC) {
+        result = QColor(Qt::darkBlue);
+    } else if (type == TT_NUMBER) {
+        result = QColor(Qt::darkGreen);
+    } else if (type == TT_LABEL) {
+        result = QColor(Qt::darkRed);
+    }
+
+    return result;
+}
@@ -0,0 +1,106 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef XDISASMVIEW_H
+#define XDISASMVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QtMath>
+
+#include "xdisasmmodel.h"
+
+class XDisasmView : public QAbstractScrollArea {
+    Q_OBJECT
+
+    static const int N_NUMBER_OF_COLUMNS = 5;
+    static const int N_CACHE_PAGES = 4;  // rows are kept for this many pages around the visible one
+    static const int N_ATLAS_FIRST = 0x20;
+    static const int N_ATLAS_LAST = 0x7E;
+
+public:
+    enum TT {
+        TT_TEXT = 0,
+        TT_MNEMONIC,
+        TT_NUMBER,
+        TT_LABEL
+    };
+
+    struct TOKEN {
+        qint32 nStart;
+        qint32 nSize;
+        TT type;
+    };
+
+    struct ROW {
+        XDisasmModel::VEIW_RECORD record;
+        QVector<TOKEN> listTokens;  // spans of record.sOpcode
+    };
+
+    explicit XDisasmView(QWidget *pParent = nullptr);
+    void setModel(XDisasmModel *pModel);
+    XDisasmModel *getModel();
+    void reload();
+    void setColumnWidth(int nColumn, int nWidth);
+    void goToPosition(qint64 nPosition);
+    qint64 getSelectionStart();
+    qint64 getSelectionCount();
+    static QVector<TOKEN> getTokens(QString sText);
+
+protected:
+    void paintEvent(QPaintEvent *pEvent) override;
+    void resizeEvent(QResizeEvent *pEvent) override;
+    void changeEvent(QEvent *pEvent) override;
+    void mousePressEvent(QMouseEvent *pEvent) override;
+    void mouseMoveEvent(QMouseEvent *pEvent) override;
+    void keyPressEvent(QKeyEvent *pEvent) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    void _updateMetrics();
+    void _updateScrollBars();
+    qint32 _getNumberOfVisibleLines();
+    qint64 _getPositionAt(QPoint point);
+    void _select(qint64 nPosition, bool bExtend);
+    void _ensureVisible(qint64 nPosition);
+    void _setFirstPosition(qint64 nPosition);
+    ROW _getRow(qint64 nPosition);
+    void _trimRows(qint64 nFirstPosition, qint32 nNumberOfLines);
+    const QPixmap *_getAtlas(QColor color);
+    void _drawText(QPainter *pPainter, qint32 nX, qint32 nY, qint32 nWidth, const QString &sText, QColor color, const QVector<TOKEN> *pListTokens = nullptr);
+    QColor _getColor(TT type);
+
+    XDisasmModel *g_pModel;
+    qint32 g_nCharWidth;
+    qint32 g_nLineHeight;
+    qint32 g_nBaseline;
+    qint32 g_listColumnWidths[N_NUMBER_OF_COLUMNS];
+    qint64 g_nSelectionAnchor;
+    qint64 g_nSelectionCursor;
+    qint64 g_nFirstPosition;  // the scroll bar only holds an int, this is the exact top row
+    qint32 g_nScrollShift;    // positions per scroll step, as a power of two
+    QHash<qint64, ROW> g_mapRows;
+    QHash<QRgb, QPixmap> g_mapAtlases;  // printable ASCII in one row, one pixmap per colour
+};
+
+#endif  // XDISASMVIEW_H
@@ -25,7 +25,7 @@
 XDisasmWidget::XDisasmWidget(QWidget *pParent) : QWidget(pParent), ui(new Ui::XDisasmWidget) {
     ui->setupUi(this);
 
-    XOptions::setMonoFont(ui->tableViewDisasm);
+    XOptions::setMonoFont(ui->viewDisasm);
 
 //    new QShortcut(QKeySequence(XShortcuts::GOTOENTRYPOINT), this, SLOT(_goToEntryPoint()));
 //    new QShortcut(QKeySequence(XShortcuts::GOTOADDRESS), this, SLOT(_goToAddress()));
@@ -75,6 +75,8 @@ void XDisasmWidget::setData(QIODevice *pDevice, XDisasmModel::SHOWOPTIONS *pShow
 
     XFormats::setFileTypeComboBox(this->g_pDisasmOptions->fileType, pDevice, ui->comboBoxType);
 
+    ui->checkBoxSkipLibraryFunctions->setChecked(this->g_pDisasmOptions->bSkipLibraryFunctions);
+
     if (bAuto) {
         analyze();
     }
@@ -87,30 +89,22 @@ void XDisasmWidget::analyze() {
 
         g_pDisasmOptions->stats = {};
 
-        QItemSelectionModel *modelOld = ui->tableViewDisasm->selectionModel();
-        ui->tableViewDisasm->setModel(0);
+        ui->viewDisasm->setModel(0);
 
         process(g_pDevice, g_pDisasmOptions, -1, XDisasm::DM_DISASM);
 
         g_pModel = new XDisasmModel(g_pDevice, &(g_pDisasmOptions->stats), g_pShowOptions, this);
 
-        ui->tableViewDisasm->setModel(g_pModel);
-        delete modelOld;
+        ui->viewDisasm->setModel(g_pModel);
 
         int nSymbolWidth = XLineEditHEX::getSymbolWidth(this);
 
         // TODO 16/32/64 width
-        ui->tableViewDisasm->setColumnWidth(0, nSymbolWidth * 14);
-        ui->tableViewDisasm->setColumnWidth(1, nSymbolWidth * 8);
-        ui->tableViewDisasm->setColumnWidth(2, nSymbolWidth * 12);
-        ui->tableViewDisasm->setColumnWidth(3, nSymbolWidth * 20);
-        ui->tableViewDisasm->setColumnWidth(4, nSymbolWidth * 8);
-
-        ui->tableViewDisasm->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Interactive);
-        ui->tableViewDisasm->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Interactive);
-        ui->tableViewDisasm->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Interactive);
-        ui->tableViewDisasm->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Interactive);
-        ui->tableViewDisasm->horizontalHeader()->setSectionResizeMode(4, QHeaderView::Stretch);
+        ui->viewDisasm->setColumnWidth(0, nSymbolWidth * 14);
+        ui->viewDisasm->setColumnWidth(1, nSymbolWidth * 8);
+        ui->viewDisasm->setColumnWidth(2, nSymbolWidth * 12);
+        ui->viewDisasm->setColumnWidth(3, nSymbolWidth * 20);
+        ui->viewDisasm->setColumnWidth(4, nSymbolWidth * 8);
 
         ui->pushButtonOverlay->setEnabled(g_pDisasmOptions->stats.bIsOverlayPresent);
 
@@ -164,6 +158,14 @@ void XDisasmWidget::disasm(qint64 nAddress) {
     goToAddress(nAddress);
 }
 
+void XDisasmWidget::linearSweep() {
+    process(g_pDevice, g_pDisasmOptions, -1, XDisasm::DM_LINEARSWEEP);
+}
+
+void XDisasmWidget::gapAnalysis() {
+    process(g_pDevice, g_pDisasmOptions, -1, XDisasm::DM_GAPANALYSIS);
+}
+
 void XDisasmWidget::toData(qint64 nAddress, qint64 nSize) {
     process(g_pDevice, g_pDisasmOptions, nAddress, XDisasm::DM_TODATA);
 
@@ -186,6 +188,167 @@ void XDisasmWidget::signature(qint64 nAddress, qint64 nSize) {
     }
 }
 
+void XDisasmWidget::scanSignatures(QString sText) {
+    if (g_pModel) {
+        XDisasmSignature disasmSignature;
+
+        if (disasmSignature.addSignatures(sText)) {
+            QList<XBinary::_MEMORY_RECORD> listRegions = XDisasm::getCodeRegions(g_pModel->getStats());
+
+            // All signatures are matched in one pass over each region
+            QList<XDisasmSignature::RESULT> listResults = disasmSignature.scan(g_pDevice, &(g_pModel->getStats()->memoryMap), &listRegions);
+
+            QList<DialogDisasmResults::RECORD> listRecords;
+
+            int nNumberOfResults = listResults.count();
+
+            for (int i = 0; i < nNumberOfResults; i++) {
+                DialogDisasmResults::RECORD record = {};
+                record.nAddress = listResults.at(i).nAddress;
+                record.sInfo = listResults.at(i).sName;
+
+                listRecords.append(record);
+            }
+
+            DialogDisasmResults dialogResults(this, g_pModel->getStats(), &listRecords, tr("Signatures"));
+
+            if (dialogResults.exec() == QDialog::Accepted) {
+                goToAddress(dialogResults.getAddress());
+            }
+        } else {
+            errorMessage(tr("Invalid signature"));
+        }
+    }
+}
+
+void XDisasmWidget::exportFingerprints(QString sFileName) {
+    process(g_pDevice, g_pDisasmOptions, -1, XDisasm::DM_EXPORTFINGERPRINTS, sFileName);
+}
+
+void XDisasmWidget::exportListing(QString sFileName) {
+    process(g_pDevice, g_pDisasmOptions, -1, XDisasm::DM_EXPORTLISTING, sFileName);
+}
+
+void XDisasmWidget::exportColumns(QString sFileName) {
+    process(g_pDevice, g_pDisasmOptions, -1, XDisasm::DM_EXPORTCOLUMNS, sFileName);
+}
+
+void XDisasmWidget::recognizeFunctions(QString sFileName) {
+    g_pDisasmOptions->sFingerprintDatabase = sFileName;
+
+    process(g_pDevice, g_pDisasmOptions, -1, XDisasm::DM_RECOGNIZEFUNCTIONS);
+}
+
+void XDisasmWidget::xrefs(qint64 nAddress) {
+    if (g_pModel) {
+        QList<DialogDisasmResults::RECORD> listRecords;
+
+        QList<XDisasm::XREF> listXrefsTo = XDisasm::getXrefsTo(g_pModel->getStats(), nAddress);
+
+        int nNumberOfXrefsTo = listXrefsTo.count();
+
+        for (int i = 0; i < nNumberOfXrefsTo; i++) {
+            DialogDisasmResults::RECORD record = {};
+            record.nAddress = listXrefsTo.at(i).nFrom;
+            record.sInfo = QString("%1 %2").arg(XDisasm::xrefTypeToString(listXrefsTo.at(i).type), tr("from"));
+
+            listRecords.append(record);
+        }
+
+        QList<XDisasm::XREF> listXrefsFrom = XDisasm::getXrefsFrom(g_pModel->getStats(), nAddress);
+
+        int nNumberOfXrefsFrom = listXrefsFrom.count();
+
+        for (int i = 0; i < nNumberOfXrefsFrom; i++) {
+            DialogDisasmResults::RECORD record = {};
+            record.nAddress = listXrefsFrom.at(i).nTo;
+            record.sInfo = QString("%1 %2").arg(XDisasm::xrefTypeToString(listXrefsFrom.at(i).type), tr("to"));
+
+            listRecords.append(record);
+        }
+
+        DialogDisasmResults dialogResults(this, g_pModel->getStats(), &listRecords, tr("Xrefs"));
+
+        if (dialogResults.exec() == QDialog::Accepted) {
+            goToAddress(dialogResults.getAddress());
+        }
+    }
+}
+
+void XDisasmWidget::search() {
+    if (g_pModel) {
+        DialogDisasmSearch dialogSearch(this, g_pDevice, g_pModel->getStats(), g_pShowOptions->bShowLabels);
+
+        if (dialogSearch.exec() == QDialog::Accepted) {
+            goToAddress(dialogSearch.getAddress());
+        }
+    }
+}
+
+void XDisasmWidget::findInstructions(qint64 nAddress) {
+    if (g_pModel) {
+        quint32 nOpcodeID = 0;
+        QList<quint64> listValues;
+        QString sMnemonic;
+
+        if (XDisasm::getQueryKeys(g_pDevice, g_pModel->getStats(), nAddress, &nOpcodeID, &listValues, &sMnemonic)) {
+            QList<DialogDisasmResults::RECORD> listRecords;
+
+            QList<qint64> listAddresses = XDisasm::getOpcodeAddresses(g_pModel->getStats(), nOpcodeID);
+
+            int nNumberOfAddresses = listAddresses.count();
+
+            for (int i = 0; i < nNumberOfAddresses; i++) {
+                DialogDisasmResults::RECORD record = {};
+                record.nAddress = listAddresses.at(i);
+                record.sInfo = sMnemonic;
+
+                listRecords.append(record);
+            }
+
+            DialogDisasmResults dialogResults(this, g_pModel->getStats(), &listRecords, tr("Instructions"));
+
+            if (dialogResults.exec() == QDialog::Accepted) {
+                goToAddress(dialogResults.getAddress());
+            }
+        }
+    }
+}
+
+void XDisasmWidget::findValues(qint64 nAddress) {
+    if (g_pModel) {
+        quint32 nOpcodeID = 0;
+        QList<quint64> listValues;
+        QString sMnemonic;
+
+        if (XDisasm::getQueryKeys(g_pDevice, g_pModel->getStats(), nAddress, &nOpcodeID, &listValues, &sMnemonic)) {
+            QList<DialogDisasmResults::RECORD> listRecords;
+
+            int nNumberOfValues = listValues.count();
+
+            for (int i = 0; i < nNumberOfValues; i++) {
+                QList<qint64> listAddresses = XDisasm::getValueAddresses(g_pModel->getStats(), listValues.at(i));
+
+                int nNumberOfAddresses = listAddresses.count();
+
+                for (int j = 0; j < nNumberOfAddresses; j++) {
+                    DialogDisasmResults::RECORD record = {};
+                    record.nAddress = listAddresses.at(j);
+                    record.sInfo = QString("0x%1").arg(listValues.at(i), 0, 16);
+
+                    listRecords.append(record);
+                }
+            }
+
+            DialogDisasmResults dialogResults(this, g_pModel->getStats(), &listRecords, tr("Values"));
+
+            if (dialogResults.exec() == QDialog::Accepted) {
+                goToAddress(dialogResults.getAddress());
+            }
+        }
+    }
+}
+
 void XDisasmWidget::hex(qint64 nOffset) {
     QHexView::OPTIONS hexOptions = {};
 
@@ -205,23 +368,23 @@ void XDisasmWidget::hex(qint64 nOffset) {
 }
 
 void XDisasmWidget::clear() {
-    ui->tableViewDisasm->setModel(0);
+    ui->viewDisasm->setModel(0);
 }
 
 XDisasmWidget::~XDisasmWidget() {
     delete ui;
 }
 
-void XDisasmWidget::process(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm) {
+void XDisasmWidget::process(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm, QString sFileName) {
     DialogDisasmProcess ddp(this);
 
     connect(&ddp, SIGNAL(errorMessage(QString)), this, SLOT(errorMessage(QString)));
 
-    ddp.setData(pDevice, pOptions, nStartAddress, dm);
+    ddp.setData(pDevice, pOptions, nStartAddress, dm, sFileName);
     ddp.exec();
 
     if (g_pModel) {
-        g_pModel->resetCache();
+        ui->viewDisasm->reload();
     }
 
     //    if(pModel)
@@ -257,7 +420,7 @@ void XDisasmWidget::on_pushButtonLabels_clicked() {
     }
 }
 
-void XDisasmWidget::on_tableViewDisasm_customContextMenuRequested(const QPoint &pos) {
+void XDisasmWidget::on_viewDisasm_customContextMenuRequested(const QPoint &pos) {
     if (g_pModel) {
         SELECTION_STAT selectionStat = getSelectionStat();
 
@@ -328,6 +491,39 @@ void XDisasmWidget::on_tableViewDisasm_customContextMenuRequested(const QPoint &
 //        actionToData.setShortcut(QKeySequence(XShortcuts::TODATA));
         connect(&actionToData, SIGNAL(triggered()), this, SLOT(_toData()));
 
+        QAction actionXrefs(tr("Xrefs"), this);
+        connect(&actionXrefs, SIGNAL(triggered()), this, SLOT(_xrefs()));
+
+        QAction actionFindInstructions(tr("Find all instructions"), this);
+        connect(&actionFindInstructions, SIGNAL(triggered()), this, SLOT(_findInstructions()));
+
+        QAction actionFindValues(tr("Find all values"), this);
+        connect(&actionFindValues, SIGNAL(triggered()), this, SLOT(_findValues()));
+
+        QAction actionSearch(tr("Search"), this);
+        connect(&actionSearch, SIGNAL(triggered()), this, SLOT(_search()));
+
+        QAction actionLinearSweep(tr("Linear sweep"), this);
+        connect(&actionLinearSweep, SIGNAL(triggered()), this, SLOT(_linearSweep()));
+
+        QAction actionGapAnalysis(tr("Gap analysis"), this);
+        connect(&actionGapAnalysis, SIGNAL(triggered()), this, SLOT(_gapAnalysis()));
+
+        QAction actionScanSignatures(tr("Scan signatures"), this);
+        connect(&actionScanSignatures, SIGNAL(triggered()), this, SLOT(_scanSignatures()));
+
+        QAction actionExportFingerprints(tr("Export fingerprints"), this);
+        connect(&actionExportFingerprints, SIGNAL(triggered()), this, SLOT(_exportFingerprints()));
+
+        QAction actionExportListing(tr("Export listing"), this);
+        connect(&actionExportListing, SIGNAL(triggered()), this, SLOT(_exportListing()));
+
+        QAction actionExportColumns(tr("Export columns"), this);
+        connect(&actionExportColumns, SIGNAL(triggered()), this, SLOT(_exportColumns()));
+
+        QAction actionRecognizeFunctions(tr("Recognize functions"), this);
+        connect(&actionRecognizeFunctions, SIGNAL(triggered()), this, SLOT(_recognizeFunctions()));
+
         contextMenu.addAction(&actionHex);
         contextMenu.addAction(&actionSignature);
 
@@ -338,9 +534,24 @@ void XDisasmWidget::on_tableViewDisasm_customContextMenuRequested(const QPoint &
         if (selectionStat.nCount == 1) {
             contextMenu.addAction(&actionDisasm);
             contextMenu.addAction(&actionToData);
+            contextMenu.addAction(&actionXrefs);
+
+            if (g_pModel->getStats()->mapVB.value(selectionStat.nAddress).type == XDisasm::VBT_OPCODE) {
+                contextMenu.addAction(&actionFindInstructions);
+                contextMenu.addAction(&actionFindValues);
+            }
         }
 
-        contextMenu.exec(ui->tableViewDisasm->viewport()->mapToGlobal(pos));
+        contextMenu.addAction(&actionSearch);
+        contextMenu.addAction(&actionLinearSweep);
+        contextMenu.addAction(&actionGapAnalysis);
+        contextMenu.addAction(&actionScanSignatures);
+        contextMenu.addAction(&actionExportFingerprints);
+        contextMenu.addAction(&actionExportListing);
+        contextMenu.addAction(&actionExportColumns);
+        contextMenu.addAction(&actionRecognizeFunctions);
+
+        contextMenu.exec(ui->viewDisasm->viewport()->mapToGlobal(pos));
 
         // TODO data -> group
         // TODO add Label
@@ -441,6 +652,30 @@ void XDisasmWidget::_disasm() {
     }
 }
 
+void XDisasmWidget::_linearSweep() {
+    if (g_pModel) {
+        SELECTION_STAT selectionStat = getSelectionStat();
+
+        linearSweep();
+
+        if (selectionStat.nCount) {
+            goToAddress(selectionStat.nAddress);
+        }
+    }
+}
+
+void XDisasmWidget::_gapAnalysis() {
+    if (g_pModel) {
+        SELECTION_STAT selectionStat = getSelectionStat();
+
+        gapAnalysis();
+
+        if (selectionStat.nCount) {
+            goToAddress(selectionStat.nAddress);
+        }
+    }
+}
+
 void XDisasmWidget::_toData() {
     if (g_pModel) {
         SELECTION_STAT selectionStat = getSelectionStat();
@@ -461,6 +696,112 @@ void XDisasmWidget::_signature() {
     }
 }
 
+void XDisasmWidget::_scanSignatures() {
+    if (g_pModel) {
+        QString sFilter;
+        sFilter += QString("%1 (*.txt)").arg(tr("Signatures"));
+        QString sFileName = QFileDialog::getOpenFileName(this, tr("Open signatures"), "", sFilter);
+
+        if (!sFileName.isEmpty()) {
+            QFile file;
+            file.setFileName(sFileName);
+
+            if (file.open(QIODevice::ReadOnly)) {
+                QString sText = QString::fromUtf8(file.readAll());
+
+                file.close();
+
+                scanSignatures(sText);
+            }
+        }
+    }
+}
+
+void XDisasmWidget::_exportFingerprints() {
+    if (g_pModel) {
+        QString sFilter;
+        sFilter += QString("%1 (*.txt)").arg(tr("Fingerprints"));
+        QString sSaveFileName = "Result.txt";
+        QString sFileName = QFileDialog::getSaveFileName(this, tr("Save fingerprints"), sSaveFileName, sFilter);
+
+        if (!sFileName.isEmpty()) {
+            exportFingerprints(sFileName);
+        }
+    }
+}
+
+void XDisasmWidget::_exportListing() {
+    if (g_pModel) {
+        QString sFilter;
+        sFilter += QString("%1 (*.asm *.txt)").arg(tr("Listing"));
+        QString sSaveFileName = "Result.asm";
+        QString sFileName = QFileDialog::getSaveFileName(this, tr("Save listing"), sSaveFileName, sFilter);
+
+        if (!sFileName.isEmpty()) {
+            exportListing(sFileName);
+        }
+    }
+}
+
+void XDisasmWidget::_exportColumns() {
+    if (g_pModel) {
+        QString sFilter;
+        sFilter += QString("%1 (*.xdc)").arg(tr("Columns"));
+        QString sSaveFileName = "Result.xdc";
+        QString sFileName = QFileDialog::getSaveFileName(this, tr("Save columns"), sSaveFileName, sFilter);
+
+        if (!sFileName.isEmpty()) {
+            exportColumns(sFileName);
+        }
+    }
+}
+
+void XDisasmWidget::_recognizeFunctions() {
+    if (g_pModel) {
+        QString sFilter;
+        sFilter += QString("%1 (*.txt)").arg(tr("Fingerprints"));
+        QString sFileName = QFileDialog::getOpenFileName(this, tr("Open fingerprints"), "", sFilter);
+
+        if (!sFileName.isEmpty()) {
+            recognizeFunctions(sFileName);
+        }
+    }
+}
+
+void XDisasmWidget::_xrefs() {
+    if (g_pModel) {
+        SELECTION_STAT selectionStat = getSelectionStat();
+
+        if (selectionStat.nCount) {
+            xrefs(selectionStat.nAddress);
+        }
+    }
+}
+
+void XDisasmWidget::_search() {
+    search();
+}
+
+void XDisasmWidget::_findInstructions() {
+    if (g_pModel) {
+        SELECTION_STAT selectionStat = getSelectionStat();
+
+        if (selectionStat.nCount) {
+            findInstructions(selectionStat.nAddress);
+        }
+    }
+}
+
+void XDisasmWidget::_findValues() {
+    if (g_pModel) {
+        SELECTION_STAT selectionStat = getSelectionStat();
+
+        if (selectionStat.nCount) {
+            findValues(selectionStat.nAddress);
+        }
+    }
+}
+
 void XDisasmWidget::_hex() {
     if (g_pModel) {
         SELECTION_STAT selectionStat = getSelectionStat();
@@ -473,19 +814,27 @@ XDisasmWidget::SELECTION_STAT XDisasmWidget::getSelectionStat() {
     SELECTION_STAT result = {};
     result.nAddress = -1;
 
-    QModelIndexList il = ui->tableViewDisasm->selectionModel()->selectedRows();
+    if (g_pModel) {
+        qint64 nStartPosition = ui->viewDisasm->getSelectionStart();
+
+        result.nCount = ui->viewDisasm->getSelectionCount();
+
+        if (result.nCount) {
+            XDisasm::STATS *pStats = g_pModel->getStats();
 
-    result.nCount = il.count();
+            result.nAddress = g_pModel->positionToAddress(nStartPosition);
+            result.nOffset = XBinary::addressToOffset(&(pStats->memoryMap), result.nAddress);
+            result.nRelAddress = XBinary::addressToRelAddress(&(pStats->memoryMap), result.nAddress);
 
-    if (result.nCount) {
-        result.nAddress = il.at(0).data(Qt::UserRole + XDisasmModel::UD_ADDRESS).toLongLong();
-        result.nOffset = il.at(0).data(Qt::UserRole + XDisasmModel::UD_OFFSET).toLongLong();
-        result.nRelAddress = il.at(0).data(Qt::UserRole + XDisasmModel::UD_RELADDRESS).toLongLong();
+            qint64 nLastElementAddress = g_pModel->positionToAddress(nStartPosition + result.nCount - 1);
+            qint64 nLastElementSize = 1;
 
-        qint64 nLastElementAddress = il.at(result.nCount - 1).data(Qt::UserRole + XDisasmModel::UD_ADDRESS).toLongLong();
-        qint64 nLastElementSize = il.at(result.nCount - 1).data(Qt::UserRole + XDisasmModel::UD_SIZE).toLongLong();
+            if (pStats->mapVB.contains(nLastElementAddress)) {
+                nLastElementSize = pStats->mapVB.value(nLastElementAddress).nSize;
+            }
 
-        result.nSize = (nLastElementAddress + nLastElementSize) - result.nAddress;
+            result.nSize = (nLastElementAddress + nLastElementSize) - result.nAddress;
+        }
     }
 
     return result;
@@ -496,13 +845,7 @@ void XDisasmWidget::on_pushButtonAnalyze_clicked() {
 }
 
 void XDisasmWidget::_goToPosition(qint32 nPosition) {
-    if (ui->tableViewDisasm->verticalScrollBar()->maximum() == 0) {
-        ui->tableViewDisasm->verticalScrollBar()->setMaximum(nPosition);  // Hack
-    }
-
-    ui->tableViewDisasm->verticalScrollBar()->setValue(nPosition);
-
-    ui->tableViewDisasm->setCurrentIndex(ui->tableViewDisasm->model()->index(nPosition, 0));
+    ui->viewDisasm->goToPosition(nPosition);
 }
 
 void XDisasmWidget::on_pushButtonOverlay_clicked() {
@@ -519,6 +862,13 @@ void XDisasmWidget::on_pushButtonHex_clicked() {
     hex(0);
 }
 
+void XDisasmWidget::on_checkBoxSkipLibraryFunctions_toggled(bool bState) {
+    // Used by the next traversal, calls into recognized library code are not followed
+    if (g_pDisasmOptions) {
+        g_pDisasmOptions->bSkipLibraryFunctions = bState;
+    }
+}
+
 void XDisasmWidget::errorMessage(QString sText) {
     QMessageBox::critical(this, tr("Error"), sText);
 }
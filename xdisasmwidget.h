@@ -30,11 +30,15 @@
 #include "dialogasmsignature.h"
 #include "dialogdisasmlabels.h"
 #include "dialogdisasmprocess.h"
+#include "dialogdisasmresults.h"
+#include "dialogdisasmsearch.h"
 #include "dialogdumpprocess.h"
 #include "dialoggotoaddress.h"
 #include "dialoghex.h"
 #include "dialoghexsignature.h"
 #include "xdisasmmodel.h"
+#include "xdisasmsignature.h"
+#include "xdisasmview.h"
 #include "xlineedithex.h"
 #include "xoptions.h"
 #include "xshortcuts.h"
@@ -64,18 +68,29 @@ public:
     void goToDisasmAddress(qint64 nAddress);
     void goToEntryPoint();
     void disasm(qint64 nAddress);
+    void linearSweep();
+    void gapAnalysis();
     void toData(qint64 nAddress, qint64 nSize);
     void signature(qint64 nAddress, qint64 nSize);
+    void scanSignatures(QString sText);
+    void exportFingerprints(QString sFileName);
+    void exportListing(QString sFileName);
+    void exportColumns(QString sFileName);
+    void recognizeFunctions(QString sFileName);
+    void xrefs(qint64 nAddress);
+    void search();
+    void findInstructions(qint64 nAddress);
+    void findValues(qint64 nAddress);
     void hex(qint64 nOffset);
     void clear();
     ~XDisasmWidget();
-    void process(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm);
+    void process(QIODevice *pDevice, XDisasm::OPTIONS *pOptions, qint64 nStartAddress, XDisasm::DM dm, QString sFileName = "");
     XDisasm::STATS *getDisasmStats();
     void setBackupFileName(QString sBackupFileName);
 
 private slots:
     void on_pushButtonLabels_clicked();
-    void on_tableViewDisasm_customContextMenuRequested(const QPoint &pos);
+    void on_viewDisasm_customContextMenuRequested(const QPoint &pos);
     void _goToAddress();
     void _goToRelAddress();
     void _goToOffset();
@@ -85,8 +100,19 @@ private slots:
     void _copyRelAddress();
     void _dumpToFile();
     void _disasm();
+    void _linearSweep();
+    void _gapAnalysis();
     void _toData();
     void _signature();
+    void _scanSignatures();
+    void _exportFingerprints();
+    void _exportListing();
+    void _exportColumns();
+    void _recognizeFunctions();
+    void _xrefs();
+    void _search();
+    void _findInstructions();
+    void _findValues();
     void _hex();
     SELECTION_STAT getSelectionStat();
     void on_pushButtonAnalyze_clicked();
@@ -94,6 +120,7 @@ private slots:
     void on_pushButtonOverlay_clicked();
     void setEdited(bool bState);
     void on_pushButtonHex_clicked();
+    void on_checkBoxSkipLibraryFunctions_toggled(bool bState);
     void errorMessage(QString sText);
 
 private: